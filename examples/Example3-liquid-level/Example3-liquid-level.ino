@@ -0,0 +1,110 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//    Ratiometric liquid level demo for the FDC1004 capacitance sensor breakout board
+//
+//    This example demonstrates the three-electrode liquid level method:
+//    - CHANNEL0: level electrode, spanning the measured height
+//    - CHANNEL1: reference electrode, always submerged
+//    - CHANNEL2: environment electrode, never submerged
+//
+//    Send 'e' over serial with the tank empty and 'f' with the tank full to
+//    calibrate. The level is then printed in 0.1% steps.
+//
+//    Author: Ashwin Whitchurch
+//    Copyright (c) 2018-2025 Protocentral Electronics
+//
+//    Arduino connections:
+//
+//    Arduino   FDC1004 board
+//    -------   -------------
+//    5V     -> Vin
+//    GND    -> GND
+//    A4     -> SDA
+//    A5     -> SCL
+//
+//    This software is licensed under the MIT License(http://opensource.org/licenses/MIT).
+//
+/////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Wire.h>
+#include <Protocentral_FDC1004.h>
+
+FDC1004 capacitanceSensor(FDC1004_RATE_100HZ);
+
+const uint16_t MEASUREMENT_DELAY_MS = 200;
+
+void handleCalibrationCommand()
+{
+    if (!Serial.available())
+    {
+        return;
+    }
+
+    char command = Serial.read();
+    fdc1004_error_t result;
+
+    if (command == 'e')
+    {
+        result = capacitanceSensor.calibrateLevelEmpty();
+        Serial.println(result == FDC1004_SUCCESS ? "Empty point stored" : "Empty calibration failed, retry");
+    }
+    else if (command == 'f')
+    {
+        result = capacitanceSensor.calibrateLevelFull();
+        Serial.println(result == FDC1004_SUCCESS ? "Full point stored" : "Full calibration failed, retry");
+    }
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Wire.begin();
+
+    Serial.println("FDC1004 Liquid Level Measurement");
+    Serial.println("================================");
+
+    if (!capacitanceSensor.begin())
+    {
+        Serial.println("✗ Failed to initialize FDC1004 sensor");
+        while (1)
+            delay(1000);
+    }
+
+    fdc1004_level_config_t config = capacitanceSensor.getLevelConfig();
+    config.level_channel = FDC1004_CHANNEL_0;
+    config.reference_channel = FDC1004_CHANNEL_1;
+    config.environment_channel = FDC1004_CHANNEL_2;
+    config.full_scale = 1000;
+    capacitanceSensor.setLevelConfig(&config);
+
+    Serial.println("Send 'e' with the tank empty, then 'f' with the tank full");
+    Serial.println("Level(0.1%)\tRatio(Q16)\tStatus");
+}
+
+void loop()
+{
+    static unsigned long lastMeasurement = 0;
+
+    handleCalibrationCommand();
+
+    if (millis() - lastMeasurement >= MEASUREMENT_DELAY_MS)
+    {
+        fdc1004_level_t level;
+        fdc1004_error_t result = capacitanceSensor.updateLevel(&level);
+
+        if (result == FDC1004_SUCCESS)
+        {
+            Serial.print(level.level);
+            Serial.print("\t\t");
+            Serial.print(level.ratio);
+            Serial.print("\t\t");
+            Serial.println(level.capdac_out_of_range ? "CAPDAC ADJUST" : "OK");
+        }
+        else
+        {
+            Serial.println("ERROR\t\t-\t\tCHECK ELECTRODES");
+        }
+
+        lastMeasurement = millis();
+    }
+}
@@ -0,0 +1,149 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//    Host benchmark for the FDC1004 batch conversion functions
+//
+//    Times per-sample conversion calls against the fdc1004_convert_* batch
+//    functions and checks that both give identical results. Build from the
+//    repository root (GCC 12 vectorises the batch loops at -O3, not at -O2):
+//
+//      g++ -std=c++11 -O3 -Isrc extras/host/conversion_benchmark.cpp src/Protocentral_FDC1004_Conversion.cpp
+//
+//    Add -march=native to use AVX where available.
+//
+//    This software is licensed under the MIT License(http://opensource.org/licenses/MIT).
+//
+//   For information on how to use, visit https://github.com/protocentral/ProtoCentral_fdc1004_breakout
+/////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Protocentral_FDC1004_Conversion.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#define SAMPLE_COUNT (1 << 20)
+#define REPEATS (50)
+
+// One call per sample, as the driver converts each reading it takes
+__attribute__((noinline)) static float convertOne(int16_t raw, uint8_t capdac)
+{
+    return fdc1004_raw_to_picofarads(raw, capdac);
+}
+
+__attribute__((noinline)) static int32_t convertOneFemtofarads(int16_t raw, uint8_t capdac)
+{
+    return fdc1004_raw_to_femtofarads(raw, capdac);
+}
+
+// Keep the compiler from discarding stores it considers unused
+static void touch(void *data)
+{
+    __asm__ __volatile__("" : : "r"(data) : "memory");
+}
+
+static double elapsedNsPerSample(std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() * 1.0e9 / ((double)REPEATS * SAMPLE_COUNT);
+}
+
+int main()
+{
+    std::vector<int16_t> raw(SAMPLE_COUNT);
+    std::vector<int32_t> raw24(SAMPLE_COUNT);
+    std::vector<uint8_t> capdac(SAMPLE_COUNT);
+    std::vector<float> picofarads(SAMPLE_COUNT);
+    std::vector<int32_t> femtofarads(SAMPLE_COUNT);
+
+    srand(1);
+    for (size_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        raw[i] = (int16_t)rand();
+        raw24[i] = (rand() % (1 << 24)) - (1 << 23);
+        capdac[i] = rand() % 32;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        for (size_t i = 0; i < SAMPLE_COUNT; i++)
+        {
+            picofarads[i] = convertOne(raw[i], capdac[i]);
+        }
+        touch(picofarads.data());
+    }
+    double scalar_pf = elapsedNsPerSample(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        for (size_t i = 0; i < SAMPLE_COUNT; i++)
+        {
+            femtofarads[i] = convertOneFemtofarads(raw[i], capdac[i]);
+        }
+        touch(femtofarads.data());
+    }
+    double scalar_ff = elapsedNsPerSample(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        fdc1004_convert_picofarads(raw.data(), capdac.data(), picofarads.data(), SAMPLE_COUNT);
+        touch(picofarads.data());
+    }
+    double batch_pf = elapsedNsPerSample(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        fdc1004_convert_femtofarads(raw.data(), capdac.data(), femtofarads.data(), SAMPLE_COUNT);
+        touch(femtofarads.data());
+    }
+    double batch_ff = elapsedNsPerSample(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        fdc1004_convert24_picofarads(raw24.data(), capdac.data(), picofarads.data(), SAMPLE_COUNT);
+        touch(picofarads.data());
+    }
+    double batch24_pf = elapsedNsPerSample(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        fdc1004_convert24_femtofarads(raw24.data(), capdac.data(), femtofarads.data(), SAMPLE_COUNT);
+        touch(femtofarads.data());
+    }
+    double batch24_ff = elapsedNsPerSample(start);
+
+    printf("16-bit to pF:  per-sample %.3f ns, batch %.3f ns (%.1fx)\n", scalar_pf, batch_pf, scalar_pf / batch_pf);
+    printf("16-bit to fF:  per-sample %.3f ns, batch %.3f ns (%.1fx)\n", scalar_ff, batch_ff, scalar_ff / batch_ff);
+    printf("24-bit to pF:  batch %.3f ns\n", batch24_pf);
+    printf("24-bit to fF:  batch %.3f ns\n", batch24_ff);
+
+    // Batch results must match the single-sample conversions exactly
+    size_t mismatches = 0;
+    fdc1004_convert_picofarads(raw.data(), capdac.data(), picofarads.data(), SAMPLE_COUNT);
+    fdc1004_convert_femtofarads(raw.data(), capdac.data(), femtofarads.data(), SAMPLE_COUNT);
+    for (size_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        if (picofarads[i] != fdc1004_raw_to_picofarads(raw[i], capdac[i]) ||
+            femtofarads[i] != fdc1004_raw_to_femtofarads(raw[i], capdac[i]))
+        {
+            mismatches++;
+        }
+    }
+
+    fdc1004_convert24_picofarads(raw24.data(), capdac.data(), picofarads.data(), SAMPLE_COUNT);
+    for (size_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        if (picofarads[i] != fdc1004_raw24_to_picofarads(raw24[i], capdac[i]))
+        {
+            mismatches++;
+        }
+    }
+
+    printf("mismatches: %zu\n", mismatches);
+    return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,221 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//    Host test for the FDC1004 compressed sample history
+//
+//    Reports the compression ratio on synthetic sensor traces and runs a
+//    randomized append/evict/read round-trip for 1-4 channels. Build and run
+//    from the repository root:
+//
+//      g++ -std=c++11 -O2 -Isrc extras/host/history_test.cpp src/Protocentral_FDC1004_History.cpp
+//
+//    This software is licensed under the MIT License(http://opensource.org/licenses/MIT).
+//
+//   For information on how to use, visit https://github.com/protocentral/ProtoCentral_fdc1004_breakout
+/////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Protocentral_FDC1004_History.h"
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define ARENA_SIZE (2048)
+#define TRACE_LENGTH (5000)
+#define FLOAT_BYTES_PER_FRAME (4 * sizeof(float))
+#define RAW_BYTES_PER_FRAME (4 * (sizeof(int16_t) + sizeof(uint8_t)))
+
+/**
+ * @brief Synthetic four-channel trace: slow drift, Gaussian noise and CAPDAC steps
+ * @param noise_lsb Noise standard deviation in raw counts
+ * @param fill_rate Level change per sample on channel 0 in raw counts
+ * @param seed Random seed
+ * @return Frames of the trace
+ */
+static std::vector<fdc1004_history_frame_t> makeTrace(double noise_lsb, double fill_rate, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, noise_lsb);
+    double base[4] = {1000, -3000, 8000, 200};
+    uint8_t capdac[4] = {3, 5, 0, 7};
+
+    std::vector<fdc1004_history_frame_t> trace(TRACE_LENGTH);
+    for (int i = 0; i < TRACE_LENGTH; i++)
+    {
+        for (int channel = 0; channel < 4; channel++)
+        {
+            base[channel] += 0.05 * sin(i / 300.0 + channel);
+            if (channel == 0)
+            {
+                base[channel] += fill_rate;
+            }
+
+            // Re-range like the driver's CAPDAC adjustment (one step is about 6626 counts)
+            if (base[channel] > 16384)
+            {
+                base[channel] -= 6626;
+                capdac[channel]++;
+            }
+            trace[i].value[channel] = (int16_t)lround(base[channel] + noise(rng));
+            trace[i].capdac[channel] = capdac[channel];
+        }
+    }
+    return trace;
+}
+
+static bool framesEqual(const fdc1004_history_frame_t *a, const fdc1004_history_frame_t *b, uint8_t channel_count)
+{
+    for (uint8_t channel = 0; channel < channel_count; channel++)
+    {
+        if (a->value[channel] != b->value[channel] || a->capdac[channel] != b->capdac[channel])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Fill an arena with a trace and report how much history it holds
+ * @return Number of decode mismatches
+ */
+static size_t reportCompression(const char *name, const std::vector<fdc1004_history_frame_t> &trace)
+{
+    static uint8_t arena[ARENA_SIZE];
+    FDC1004History history(arena, sizeof(arena), 4);
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+        history.append(&trace[i]);
+    }
+
+    uint32_t frames = history.getFrameCount();
+    printf("%-28s %5u frames in %d bytes, %.2f B/frame, %.1fx vs float, %.1fx vs int16+CAPDAC\n",
+           name, frames, ARENA_SIZE, (double)history.getUsedBytes() / frames,
+           (double)frames * FLOAT_BYTES_PER_FRAME / ARENA_SIZE,
+           (double)frames * RAW_BYTES_PER_FRAME / ARENA_SIZE);
+
+    size_t mismatches = 0;
+    size_t index = trace.size() - frames;
+    fdc1004_history_frame_t frame;
+    history.rewind();
+    while (history.readNext(&frame))
+    {
+        if (index >= trace.size() || !framesEqual(&frame, &trace[index], 4))
+        {
+            mismatches++;
+        }
+        index++;
+    }
+    if (index != trace.size())
+    {
+        mismatches++;
+    }
+    return mismatches;
+}
+
+/**
+ * @brief Random appends, reads and rewinds checked against the full input sequence
+ * @return Number of mismatches
+ */
+static size_t randomRoundTrip(uint8_t channel_count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> any_value(-32768, 32767);
+    std::uniform_int_distribution<int> small_step(-6, 6);
+    std::uniform_int_distribution<int> any_capdac(0, 31);
+
+    static uint8_t arena[4096];
+    size_t arena_size = FDC1004_HISTORY_BLOCK_SIZE * (2 + rng() % 30);
+    FDC1004History history(arena, arena_size, channel_count);
+
+    std::vector<fdc1004_history_frame_t> appended;
+    fdc1004_history_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    size_t cursor = 0; // index in appended of the next frame readNext() must return
+    size_t mismatches = 0;
+
+    for (int operation = 0; operation < 200000; operation++)
+    {
+        int choice = percent(rng);
+        size_t oldest = appended.size() - history.getFrameCount();
+
+        if (choice < 70)
+        {
+            for (uint8_t channel = 0; channel < channel_count; channel++)
+            {
+                int kind = percent(rng);
+                if (kind < 2)
+                {
+                    frame.value[channel] = (int16_t)any_value(rng);      // full-range jump
+                }
+                else if (kind < 4)
+                {
+                    frame.capdac[channel] = (uint8_t)any_capdac(rng);    // CAPDAC change
+                }
+                else
+                {
+                    frame.value[channel] = (int16_t)(frame.value[channel] + small_step(rng));
+                }
+            }
+            history.append(&frame);
+            appended.push_back(frame);
+        }
+        else if (choice < 97)
+        {
+            // An evicted cursor resumes at the oldest stored frame
+            if (cursor < oldest)
+            {
+                cursor = oldest;
+            }
+
+            fdc1004_history_frame_t decoded;
+            bool read = history.readNext(&decoded);
+            if (read != (cursor < appended.size()))
+            {
+                mismatches++;
+            }
+            else if (read)
+            {
+                if (!framesEqual(&decoded, &appended[cursor], channel_count))
+                {
+                    mismatches++;
+                }
+                cursor++;
+            }
+        }
+        else
+        {
+            history.rewind();
+            cursor = oldest;
+        }
+    }
+    return mismatches;
+}
+
+int main()
+{
+    size_t mismatches = 0;
+
+    printf("Compression, %d-byte arena, four channels:\n", ARENA_SIZE);
+    mismatches += reportCompression("steady, 2 LSB noise", makeTrace(2.0, 0.0, 1));
+    mismatches += reportCompression("filling tank, 2 LSB noise", makeTrace(2.0, 5.0, 2));
+    mismatches += reportCompression("steady, 8 LSB noise", makeTrace(8.0, 0.0, 3));
+
+    printf("Randomized append/evict/read round trip:\n");
+    for (uint8_t channel_count = 1; channel_count <= FDC1004_HISTORY_MAX_CHANNELS; channel_count++)
+    {
+        for (unsigned seed = 1; seed <= 5; seed++)
+        {
+            size_t errors = randomRoundTrip(channel_count, seed * 10 + channel_count);
+            mismatches += errors;
+            if (errors != 0)
+            {
+                printf("  %u channels, seed %u: %zu mismatches\n", channel_count, seed, errors);
+            }
+        }
+    }
+
+    printf("mismatches: %zu\n", mismatches);
+    return (mismatches == 0) ? 0 : 1;
+}
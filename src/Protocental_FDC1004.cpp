@@ -19,6 +19,17 @@
 /////////////////////////////////////////////////////////////////////////////////////////
 
 #include <Protocentral_FDC1004.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef FDC1004_LINUX_I2CDEV
+#include <fcntl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+#endif
 
 // =============================================================================
 // Private Constants
@@ -36,34 +47,222 @@ static const uint8_t MEASUREMENT_LSB_REGISTERS[] = {
     FDC1004_REG_MEAS1_LSB, FDC1004_REG_MEAS2_LSB,
     FDC1004_REG_MEAS3_LSB, FDC1004_REG_MEAS4_LSB};
 
+static const uint8_t OFFSET_CALIBRATION_REGISTERS[] = {
+    FDC1004_REG_OFFSET_CAL_CIN1, FDC1004_REG_OFFSET_CAL_CIN2,
+    FDC1004_REG_OFFSET_CAL_CIN3, FDC1004_REG_OFFSET_CAL_CIN4};
+
+static const uint8_t GAIN_CALIBRATION_REGISTERS[] = {
+    FDC1004_REG_GAIN_CAL_CIN1, FDC1004_REG_GAIN_CAL_CIN2,
+    FDC1004_REG_GAIN_CAL_CIN3, FDC1004_REG_GAIN_CAL_CIN4};
+
 static const uint8_t SAMPLE_DELAYS_MS[] = {11, 11, 6, 3}; // Delays for 100Hz, 200Hz, 400Hz
 
+static const uint32_t CONVERSION_PERIODS_US[] = {10000, 5000, 2500}; // Per-slot conversion time for 100Hz, 200Hz, 400Hz
+
+#ifdef FDC1004_LINUX_I2CDEV
+// Arduino timing primitives for the Linux backend
+
+static void delay(unsigned long ms)
+{
+    struct timespec duration;
+    duration.tv_sec = ms / 1000;
+    duration.tv_nsec = (long)(ms % 1000) * 1000000L;
+    while (nanosleep(&duration, &duration) != 0)
+    {
+        // Resume after signal interruption
+    }
+}
+
+static void delayMicroseconds(unsigned int us)
+{
+    struct timespec duration;
+    duration.tv_sec = 0;
+    duration.tv_nsec = (long)us * 1000L;
+    while (nanosleep(&duration, &duration) != 0)
+    {
+        // Resume after signal interruption
+    }
+}
+
+static unsigned long millis()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long)((uint64_t)now.tv_sec * 1000ULL + (uint64_t)now.tv_nsec / 1000000ULL);
+}
+
+static unsigned long micros()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long)((uint64_t)now.tv_sec * 1000000ULL + (uint64_t)now.tv_nsec / 1000ULL);
+}
+#endif
+
+static void waitUntilMicros(uint32_t deadline_us)
+{
+    int32_t remaining_us = (int32_t)(deadline_us - micros());
+    if (remaining_us > 0)
+    {
+        delay(remaining_us / 1000);
+        delayMicroseconds(remaining_us % 1000);
+    }
+}
+
+static uint16_t stateChecksum(const fdc1004_state_t *state)
+{
+    // Fletcher-16 over every field preceding the checksum
+    const uint8_t *data = (const uint8_t *)state;
+    uint16_t sum1 = 0;
+    uint16_t sum2 = 0;
+    for (size_t i = 0; i < offsetof(fdc1004_state_t, checksum); i++)
+    {
+        sum1 = (sum1 + data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (sum2 << 8) | sum1;
+}
+
+static uint32_t squareRoot64(uint64_t value)
+{
+    // Bitwise integer square root, rounded down
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+static void accumulateSample(fdc1004_window_accumulator_t *accumulator, int32_t value_af)
+{
+    if (accumulator->count == 0)
+    {
+        accumulator->offset_af = value_af;
+        accumulator->min_af = value_af;
+        accumulator->max_af = value_af;
+        accumulator->sum = 0;
+        accumulator->sum_squares = 0;
+    }
+    accumulator->count++;
+
+    // Offsets from the first sample keep the exact integer sums small
+    int64_t offset = (int64_t)value_af - accumulator->offset_af;
+    uint64_t square = (uint64_t)(offset * offset);
+    accumulator->sum += offset;
+    accumulator->sum_squares = (accumulator->sum_squares + square < accumulator->sum_squares)
+                                   ? UINT64_MAX
+                                   : accumulator->sum_squares + square;
+
+    if (value_af < accumulator->min_af)
+    {
+        accumulator->min_af = value_af;
+    }
+    if (value_af > accumulator->max_af)
+    {
+        accumulator->max_af = value_af;
+    }
+}
+
+static int32_t sampleMean(const fdc1004_window_accumulator_t *accumulator)
+{
+    int64_t count = accumulator->count;
+    int64_t sum = accumulator->sum;
+    int64_t rounded = (sum >= 0) ? (sum + count / 2) / count : (sum - count / 2) / count;
+    return (int32_t)(accumulator->offset_af + rounded);
+}
+
+static uint32_t sampleDeviation(const fdc1004_window_accumulator_t *accumulator)
+{
+    if (accumulator->count < 2)
+    {
+        return 0;
+    }
+    if (accumulator->sum_squares == UINT64_MAX)
+    {
+        return UINT32_MAX;
+    }
+
+    // m2 = sum_squares - sum^2 / count, split so sum^2 cannot overflow; the
+    // split products are bounded by sum_squares
+    int64_t count = accumulator->count;
+    int64_t sum = accumulator->sum;
+    int64_t quotient = sum / count;
+    int64_t remainder = sum - quotient * count;
+    uint64_t correction = (uint64_t)(quotient * sum) + (uint64_t)((remainder * sum) / count);
+    uint64_t m2 = (accumulator->sum_squares > correction) ? accumulator->sum_squares - correction : 0;
+    return squareRoot64(m2 / (uint64_t)(count - 1));
+}
+
 // =============================================================================
 // Constructors and Initialization
 // =============================================================================
 
-FDC1004::FDC1004(fdc1004_sample_rate_t rate, uint8_t address, TwoWire* wire)
-    : _i2c_address(address), _sample_rate(rate), _device_initialized(false), _wire(wire)
+#ifdef FDC1004_LINUX_I2CDEV
+FDC1004::FDC1004(fdc1004_sample_rate_t rate, uint8_t address, const char* device)
+    : _i2c_address(address), _sample_rate(rate), _device_initialized(false),
+      _device_path(device), _fd(-1), _ioctl(nullptr), _ioctl_context(nullptr)
 {
-    // Initialize CAPDAC values to zero
-    for (int i = 0; i < 4; i++)
+    resetChannelState();
+}
+
+FDC1004::FDC1004(const char* device, fdc1004_sample_rate_t rate, uint8_t address)
+    : _i2c_address(address), _sample_rate(rate), _device_initialized(false),
+      _device_path(device), _fd(-1), _ioctl(nullptr), _ioctl_context(nullptr)
+{
+    resetChannelState();
+}
+
+FDC1004::~FDC1004()
+{
+    if (_fd >= 0)
     {
-        _capdac_values[i] = 0;
+        close(_fd);
     }
 }
 
+void FDC1004::setIoctlHandler(fdc1004_ioctl_t handler, void* context)
+{
+    _ioctl = handler;
+    _ioctl_context = context;
+}
+#else
+FDC1004::FDC1004(fdc1004_sample_rate_t rate, uint8_t address, TwoWire* wire)
+    : _i2c_address(address), _sample_rate(rate), _device_initialized(false), _wire(wire)
+{
+    resetChannelState();
+}
+
 FDC1004::FDC1004(TwoWire* wire, fdc1004_sample_rate_t rate, uint8_t address)
     : _i2c_address(address), _sample_rate(rate), _device_initialized(false), _wire(wire)
 {
-    // Initialize CAPDAC values to zero
-    for (int i = 0; i < 4; i++)
-    {
-        _capdac_values[i] = 0;
-    }
+    resetChannelState();
 }
 
+#endif
+
+#ifdef FDC1004_LINUX_I2CDEV
+FDC1004::FDC1004(uint16_t rate)
+    : _i2c_address(FDC1004_I2C_ADDRESS), _device_initialized(false),
+      _device_path(FDC1004_LINUX_I2C_DEVICE), _fd(-1), _ioctl(nullptr), _ioctl_context(nullptr)
+#else
 FDC1004::FDC1004(uint16_t rate)
     : _i2c_address(FDC1004_I2C_ADDRESS), _device_initialized(false), _wire(&Wire)
+#endif
 {
     // Legacy constructor - convert rate to new enum
     switch (rate)
@@ -82,25 +281,48 @@ FDC1004::FDC1004(uint16_t rate)
         break;
     }
 
-    // Initialize CAPDAC values to zero
-    for (int i = 0; i < 4; i++)
+    resetChannelState();
+}
+
+bool FDC1004::begin()
+{
+    if (initializeDevice() != FDC1004_SUCCESS)
     {
-        _capdac_values[i] = 0;
+        return false;
+    }
+
+    // The device may have kept its configuration across an MCU reset
+    if (readStateRegisters() != FDC1004_SUCCESS)
+    {
+        return false;
     }
+
+    _device_initialized = true;
+    return true;
 }
 
-bool FDC1004::begin()
+bool FDC1004::begin(const fdc1004_state_t *state)
 {
-    // Initialize the TwoWire interface
-    _wire->begin();
-    
-    // Check if device is responding
-    if (!isConnected())
+    if (initializeDevice() != FDC1004_SUCCESS)
     {
         return false;
     }
 
     _device_initialized = true;
+
+    // A blank or corrupted state leaves the sensor in its cold-start configuration
+    fdc1004_error_t result = importState(state);
+    if (result == FDC1004_ERROR_INVALID_PARAMETER)
+    {
+        result = readStateRegisters();
+    }
+
+    if (result != FDC1004_SUCCESS)
+    {
+        _device_initialized = false;
+        return false;
+    }
+
     return true;
 }
 
@@ -134,6 +356,10 @@ fdc1004_capacitance_t FDC1004::getCapacitanceMeasurement(fdc1004_channel_t chann
     {
         result.capacitance_pf = convertToPicofarads(raw_measurement.value, raw_measurement.capdac);
         result.capdac_used = raw_measurement.capdac;
+        beginPublish();
+        recordChannelSample(channel, &raw_measurement, _slot_timestamps_us[channel]);
+        endPublish();
+        updateStatistics(channel, &raw_measurement, _slot_timestamps_us[channel]);
 
         // Check if CAPDAC adjustment is needed
         if (raw_measurement.value > FDC1004_UPPER_BOUND ||
@@ -169,163 +395,951 @@ int32_t FDC1004::getCapacitance(uint8_t channel)
     }
 
     // Convert to femtofarads (legacy format)
-    int32_t capacitance = ((int32_t)FDC1004_ATTOFARADS_UPPER_WORD) * ((int32_t)value.value);
-    capacitance /= 1000; // Convert attofarads to femtofarads
-    capacitance += ((int32_t)FDC1004_FEMTOFARADS_CAPDAC) * ((int32_t)value.capdac);
-    return capacitance;
+    return fdc1004_raw_to_femtofarads(value.value, value.capdac);
 }
 
-// =============================================================================
-// Configuration and Control
-// =============================================================================
-
-fdc1004_error_t FDC1004::setSampleRate(fdc1004_sample_rate_t rate)
+fdc1004_error_t FDC1004::getAlignedSnapshot(fdc1004_snapshot_t *snapshot,
+                                            fdc1004_align_policy_t policy,
+                                            uint8_t channel_mask)
 {
-    if (!isValidSampleRate(rate))
+    channel_mask &= FDC1004_FDC_CONF_MEAS_MASK;
+    if (snapshot == nullptr || channel_mask == 0)
     {
         return FDC1004_ERROR_INVALID_PARAMETER;
     }
 
-    _sample_rate = rate;
-    return FDC1004_SUCCESS;
-}
+    if (!_device_initialized)
+    {
+        return FDC1004_ERROR_DEVICE_NOT_FOUND;
+    }
 
-fdc1004_sample_rate_t FDC1004::getSampleRate() const
-{
-    return _sample_rate;
-}
+    fdc1004_raw_measurement_t raw[4];
+    fdc1004_error_t result = scanChannels(channel_mask, raw);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
 
-fdc1004_error_t FDC1004::setCapdac(fdc1004_channel_t channel, uint8_t capdac)
-{
-    if (!isValidChannel(channel) || !isValidCapdac(capdac))
+    // Slots convert in ascending order, so the lowest channel finished first
+    // and the highest channel last
+    uint32_t first_us = 0;
+    uint32_t last_us = 0;
+    bool first = true;
+    for (uint8_t channel = 0; channel <= FDC1004_CHANNEL_MAX; channel++)
     {
-        return FDC1004_ERROR_INVALID_PARAMETER;
+        if (!(channel_mask & (1 << channel)))
+        {
+            continue;
+        }
+
+        uint32_t timestamp = _slot_timestamps_us[channel];
+        if (first)
+        {
+            first_us = timestamp;
+            first = false;
+        }
+        last_us = timestamp;
+    }
+
+    snapshot->channel_mask = channel_mask;
+    snapshot->timestamp_us = first_us;
+    snapshot->skew_us = last_us - first_us;
+
+    for (uint8_t channel = 0; channel <= FDC1004_CHANNEL_MAX; channel++)
+    {
+        if (!(channel_mask & (1 << channel)))
+        {
+            snapshot->capacitance_pf[channel] = NAN;
+            snapshot->capdac_used[channel] = 0;
+            continue;
+        }
+
+        snapshot->capdac_used[channel] = raw[channel].capdac;
+
+        float latest = _latest_pf[channel];
+        if (_sample_history[channel] < 2)
+        {
+            snapshot->capacitance_pf[channel] = latest;
+            continue;
+        }
+
+        // Differences are taken as signed 32-bit values so micros() wrap-around is harmless
+        float previous = _previous_pf[channel];
+        int32_t span_us = (int32_t)(_latest_us[channel] - _previous_us[channel]);
+        int32_t offset_us = (int32_t)(first_us - _previous_us[channel]);
+
+        if (policy == FDC1004_ALIGN_SAMPLE_HOLD)
+        {
+            snapshot->capacitance_pf[channel] = ((int32_t)(_latest_us[channel] - first_us) <= 0) ? latest : previous;
+        }
+        else if (span_us > 0)
+        {
+            snapshot->capacitance_pf[channel] = previous + (latest - previous) * ((float)offset_us / (float)span_us);
+        }
+        else
+        {
+            snapshot->capacitance_pf[channel] = latest;
+        }
     }
 
-    _capdac_values[channel] = capdac;
     return FDC1004_SUCCESS;
 }
 
-uint8_t FDC1004::getCapdac(fdc1004_channel_t channel) const
+fdc1004_error_t FDC1004::runSequence(const fdc1004_logical_measurement_t *measurements,
+                                     uint8_t count,
+                                     fdc1004_sequence_result_t *results)
 {
-    if (!isValidChannel(channel))
+    if (measurements == nullptr || results == nullptr || count == 0)
     {
-        return 0;
+        return FDC1004_ERROR_INVALID_PARAMETER;
     }
-    return _capdac_values[channel];
-}
 
-// =============================================================================
-// Low-Level Hardware Interface (New Implementation)
-// =============================================================================
+    if (!_device_initialized)
+    {
+        return FDC1004_ERROR_DEVICE_NOT_FOUND;
+    }
 
-fdc1004_error_t FDC1004::configureMeasurementSingle(fdc1004_measurement_t measurement,
-                                                    fdc1004_channel_t channel,
-                                                    uint8_t capdac)
-{
-    if (!isValidMeasurement(measurement) || !isValidChannel(channel) || !isValidCapdac(capdac))
+    // Validate the whole list up front so a bad entry cannot stop the pipeline halfway
+    uint16_t config;
+    for (uint8_t i = 0; i < count; i++)
     {
-        return FDC1004_ERROR_INVALID_PARAMETER;
+        if (buildSlotConfig(&measurements[i], &config) != FDC1004_SUCCESS)
+        {
+            return FDC1004_ERROR_INVALID_PARAMETER;
+        }
     }
 
-    // Build 16-bit configuration
-    uint16_t configuration_data = 0;
-    configuration_data |= ((uint16_t)channel) << FDC1004_CONF_MEAS_CHA_SHIFT;            // CHA
-    configuration_data |= FDC1004_CONF_MEAS_CHB_DISABLED << FDC1004_CONF_MEAS_CHB_SHIFT; // CHB disable
-    configuration_data |= ((uint16_t)capdac) << FDC1004_CONF_MEAS_CAPDAC_SHIFT;          // CAPDAC value
+    // Entry index loaded into each slot, -1 if the slot is unused
+    int16_t slot_entry[4];
+    uint8_t next = 0;
+    uint8_t slot_mask = 0;
+    for (uint8_t slot = 0; slot <= FDC1004_MEASUREMENT_MAX; slot++)
+    {
+        slot_entry[slot] = -1;
+        if (next < count)
+        {
+            buildSlotConfig(&measurements[next], &config);
+            fdc1004_error_t result = loadSlotConfig((fdc1004_measurement_t)slot, config);
+            if (result != FDC1004_SUCCESS)
+            {
+                return result;
+            }
+            slot_entry[slot] = next++;
+            slot_mask |= (1 << slot);
+        }
+    }
+
+    while (slot_mask != 0)
+    {
+        fdc1004_error_t result = triggerMeasurements(slot_mask, _sample_rate);
+        if (result != FDC1004_SUCCESS)
+        {
+            return result;
+        }
 
-    return writeRegister16(MEASUREMENT_CONFIG_REGISTERS[measurement], configuration_data);
+        uint8_t next_mask = 0;
+        for (uint8_t slot = 0; slot <= FDC1004_MEASUREMENT_MAX; slot++)
+        {
+            if (!(slot_mask & (1 << slot)))
+            {
+                continue;
+            }
+
+            // Slots finish in ascending order; later slots keep converting while this one is serviced
+            waitUntilMicros(_slot_timestamps_us[slot]);
+            result = waitForMeasurements(1 << slot);
+            if (result != FDC1004_SUCCESS)
+            {
+                return result;
+            }
+
+            uint16_t raw_measurement[2];
+            const uint8_t registers[2] = {MEASUREMENT_MSB_REGISTERS[slot], MEASUREMENT_LSB_REGISTERS[slot]};
+            result = readRegisters16(registers, raw_measurement, 2);
+            if (result != FDC1004_SUCCESS)
+            {
+                return result;
+            }
+
+            const fdc1004_logical_measurement_t *entry = &measurements[slot_entry[slot]];
+            fdc1004_sequence_result_t *output = &results[slot_entry[slot]];
+            uint8_t capdac = (entry->negative == FDC1004_CONF_MEAS_CHB_DISABLED) ? entry->capdac : 0;
+            output->value = fdc1004_raw24(raw_measurement[0], raw_measurement[1]);
+            output->capacitance_pf = fdc1004_raw24_to_picofarads(output->value, capdac);
+            output->timestamp_us = _slot_timestamps_us[slot];
+
+            // Reprogram the finished slot for the next round
+            slot_entry[slot] = -1;
+            if (next < count)
+            {
+                buildSlotConfig(&measurements[next], &config);
+                result = loadSlotConfig((fdc1004_measurement_t)slot, config);
+                if (result != FDC1004_SUCCESS)
+                {
+                    return result;
+                }
+                slot_entry[slot] = next++;
+                next_mask |= (1 << slot);
+            }
+        }
+
+        slot_mask = next_mask;
+    }
+
+    return FDC1004_SUCCESS;
 }
 
-fdc1004_error_t FDC1004::triggerSingleMeasurement(fdc1004_measurement_t measurement,
-                                                  fdc1004_sample_rate_t rate)
+// =============================================================================
+// Liquid Level
+// =============================================================================
+
+fdc1004_error_t FDC1004::setLevelConfig(const fdc1004_level_config_t *config)
 {
-    if (!isValidMeasurement(measurement) || !isValidSampleRate(rate))
+    if (config == nullptr ||
+        !isValidChannel(config->level_channel) ||
+        !isValidChannel(config->reference_channel) ||
+        !isValidChannel(config->environment_channel) ||
+        config->level_channel == config->reference_channel ||
+        config->level_channel == config->environment_channel ||
+        config->reference_channel == config->environment_channel ||
+        config->full_ratio <= 0)
     {
         return FDC1004_ERROR_INVALID_PARAMETER;
     }
 
-    uint16_t trigger_data = 0;
-    trigger_data |= ((uint16_t)rate) << FDC1004_FDC_CONF_RATE_SHIFT; // Sample rate
-    trigger_data |= 0 << FDC1004_FDC_CONF_REPEAT_SHIFT;              // Repeat disabled
-    trigger_data |= (1 << (7 - measurement));                        // Enable measurement
+    _level_config = *config;
+    return FDC1004_SUCCESS;
+}
 
-    return writeRegister16(FDC1004_REG_FDC_CONF, trigger_data);
+fdc1004_level_config_t FDC1004::getLevelConfig() const
+{
+    return _level_config;
 }
 
-fdc1004_error_t FDC1004::readMeasurement(fdc1004_measurement_t measurement, uint16_t *value)
+fdc1004_error_t FDC1004::calibrateLevelEmpty()
 {
-    if (!isValidMeasurement(measurement) || value == nullptr)
-    {
-        return FDC1004_ERROR_INVALID_PARAMETER;
-    }
+    fdc1004_level_t level;
+    fdc1004_error_t result = scanLevelElectrodes(&level);
 
-    // Check if measurement is complete
-    uint16_t fdc_register;
-    fdc1004_error_t result = readRegister16(FDC1004_REG_FDC_CONF, &fdc_register);
-    if (result != FDC1004_SUCCESS)
+    // Only the level electrode is needed here; with the tank empty the reference
+    // and environment electrodes may read the same, leaving no ratio to compute
+    if (result != FDC1004_SUCCESS && result != FDC1004_ERROR_INVALID_PARAMETER)
     {
         return result;
     }
 
-    if (!(fdc_register & (1 << (3 - measurement))))
+    if (level.capdac_out_of_range)
     {
-        return FDC1004_ERROR_MEASUREMENT_NOT_READY;
+        return FDC1004_ERROR_CAPDAC_OUT_OF_RANGE;
     }
 
-    // Read the measurement values
-    uint16_t msb, lsb;
-    result = readRegister16(MEASUREMENT_MSB_REGISTERS[measurement], &msb);
+    _level_config.empty_level_af = level.level_af;
+    return FDC1004_SUCCESS;
+}
+
+fdc1004_error_t FDC1004::calibrateLevelFull()
+{
+    fdc1004_level_t level;
+    fdc1004_error_t result = scanLevelElectrodes(&level);
     if (result != FDC1004_SUCCESS)
     {
         return result;
     }
 
-    result = readRegister16(MEASUREMENT_LSB_REGISTERS[measurement], &lsb);
-    if (result != FDC1004_SUCCESS)
+    if (level.capdac_out_of_range)
     {
-        return result;
+        return FDC1004_ERROR_CAPDAC_OUT_OF_RANGE;
+    }
+
+    if (level.ratio <= 0)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
     }
 
-    value[0] = msb;
-    value[1] = lsb;
+    _level_config.full_ratio = level.ratio;
     return FDC1004_SUCCESS;
 }
 
-fdc1004_error_t FDC1004::measureChannel(fdc1004_channel_t channel, uint8_t capdac, uint16_t *value)
+fdc1004_error_t FDC1004::updateLevel(fdc1004_level_t *level)
 {
-    if (!isValidChannel(channel) || !isValidCapdac(capdac) || value == nullptr)
+    if (level == nullptr)
     {
         return FDC1004_ERROR_INVALID_PARAMETER;
     }
 
-    // Use measurement slot equal to channel number
-    fdc1004_measurement_t measurement = (fdc1004_measurement_t)channel;
-
-    fdc1004_error_t result = configureMeasurementSingle(measurement, channel, capdac);
+    fdc1004_error_t result = scanLevelElectrodes(level);
     if (result != FDC1004_SUCCESS)
     {
         return result;
     }
 
-    result = triggerSingleMeasurement(measurement, _sample_rate);
-    if (result != FDC1004_SUCCESS)
+    // level = ratio / full_ratio * full_scale, clamped to the tank
+    int32_t scaled = (int32_t)(((int64_t)level->ratio * _level_config.full_scale) / _level_config.full_ratio);
+    if (scaled < 0)
     {
-        return result;
+        scaled = 0;
+    }
+    else if (scaled > _level_config.full_scale)
+    {
+        scaled = _level_config.full_scale;
     }
+    level->level = (uint16_t)scaled;
 
-    delay(getMeasurementDelay());
-    return readMeasurement(measurement, value);
+    return FDC1004_SUCCESS;
 }
 
-fdc1004_error_t FDC1004::getRawCapacitance(fdc1004_channel_t channel, fdc1004_raw_measurement_t *value)
+// =============================================================================
+// Adaptive Sampling
+// =============================================================================
+
+fdc1004_error_t FDC1004::setAdaptiveSampling(const fdc1004_adaptive_config_t *config)
 {
-    if (!isValidChannel(channel) || value == nullptr)
+    if (config == nullptr)
     {
-        return FDC1004_ERROR_INVALID_PARAMETER;
+        if (_adaptive_enabled)
+        {
+            _adaptive_enabled = false;
+            setSampleRate(_adaptive_saved_rate);
+        }
+        return FDC1004_SUCCESS;
     }
 
-    uint8_t capdac = _capdac_values[channel];
+    if ((config->channel_mask & FDC1004_FDC_CONF_MEAS_MASK) == 0 ||
+        !isValidSampleRate(config->idle_rate) ||
+        config->quiet_threshold_ff_per_s > config->activity_threshold_ff_per_s)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    // Keep the caller's rate across reconfiguration so disabling can restore it
+    if (!_adaptive_enabled)
+    {
+        _adaptive_saved_rate = _sample_rate;
+    }
+
+    _adaptive_config = *config;
+    _adaptive_config.channel_mask &= FDC1004_FDC_CONF_MEAS_MASK;
+    _adaptive_state = FDC1004_ADAPTIVE_IDLE;
+    _adaptive_enabled = true;
+    _adaptive_reference_valid = false;
+    setSampleRate(config->idle_rate);
+
+    // First update scans immediately
+    _adaptive_last_scan_ms = millis() - config->idle_interval_ms;
+    return FDC1004_SUCCESS;
+}
+
+fdc1004_error_t FDC1004::updateAdaptive(fdc1004_snapshot_t *snapshot)
+{
+    if (!_adaptive_enabled || snapshot == nullptr)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    if (getAdaptiveDelayMs() > 0)
+    {
+        return FDC1004_ERROR_MEASUREMENT_NOT_READY;
+    }
+
+    uint32_t now_ms = millis();
+    _adaptive_last_scan_ms = now_ms;
+
+    fdc1004_error_t result = getAlignedSnapshot(snapshot, FDC1004_ALIGN_LINEAR, _adaptive_config.channel_mask);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    // Activity is measured against a reference scan at least idle_interval_ms
+    // old, so idle and active scans see the same noise floor in fF/s
+    if (!_adaptive_reference_valid)
+    {
+        markAdaptiveReference(now_ms);
+        return FDC1004_SUCCESS;
+    }
+    if (now_ms - _adaptive_reference_ms < _adaptive_config.idle_interval_ms)
+    {
+        return FDC1004_SUCCESS;
+    }
+
+    // Fastest per-channel rate of change since the reference scan, in fF/s
+    float max_rate = 0.0f;
+    for (uint8_t channel = 0; channel <= FDC1004_CHANNEL_MAX; channel++)
+    {
+        if (!(_adaptive_config.channel_mask & (1 << channel)))
+        {
+            continue;
+        }
+
+        int32_t span_us = (int32_t)(_latest_us[channel] - _adaptive_reference_us[channel]);
+        if (span_us <= 0)
+        {
+            continue;
+        }
+
+        float rate = fabsf(_latest_pf[channel] - _adaptive_reference_pf[channel]) * 1.0e9f / (float)span_us;
+        if (rate > max_rate)
+        {
+            max_rate = rate;
+        }
+    }
+    markAdaptiveReference(now_ms);
+
+    if (_adaptive_state == FDC1004_ADAPTIVE_IDLE)
+    {
+        if (max_rate >= (float)_adaptive_config.activity_threshold_ff_per_s)
+        {
+            _adaptive_state = FDC1004_ADAPTIVE_ACTIVE;
+            _adaptive_quiet_since_ms = now_ms;
+            setSampleRate(FDC1004_RATE_400HZ);
+        }
+    }
+    else if (max_rate >= (float)_adaptive_config.quiet_threshold_ff_per_s)
+    {
+        _adaptive_quiet_since_ms = now_ms;
+    }
+    else if (now_ms - _adaptive_quiet_since_ms >= _adaptive_config.quiet_hold_ms)
+    {
+        _adaptive_state = FDC1004_ADAPTIVE_IDLE;
+        setSampleRate(_adaptive_config.idle_rate);
+    }
+
+    return FDC1004_SUCCESS;
+}
+
+uint32_t FDC1004::getAdaptiveDelayMs() const
+{
+    if (!_adaptive_enabled)
+    {
+        return 0;
+    }
+
+    uint32_t interval_ms = (_adaptive_state == FDC1004_ADAPTIVE_ACTIVE) ? _adaptive_config.active_interval_ms
+                                                                        : _adaptive_config.idle_interval_ms;
+    uint32_t elapsed_ms = millis() - _adaptive_last_scan_ms;
+    return (elapsed_ms >= interval_ms) ? 0 : interval_ms - elapsed_ms;
+}
+
+fdc1004_adaptive_state_t FDC1004::getAdaptiveState() const
+{
+    return _adaptive_state;
+}
+
+// =============================================================================
+// Window Statistics
+// =============================================================================
+
+fdc1004_error_t FDC1004::setStatisticsWindow(uint8_t window, uint32_t duration_ms, fdc1004_stats_window_t *storage)
+{
+    if (window >= FDC1004_STATS_WINDOWS ||
+        (storage != nullptr && (duration_ms == 0 || duration_ms > FDC1004_STATS_MAX_WINDOW_MS)))
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    if (storage != nullptr)
+    {
+        storage->duration_us = duration_ms * 1000;
+        storage->ready = 0;
+        for (uint8_t channel = 0; channel <= FDC1004_CHANNEL_MAX; channel++)
+        {
+            storage->current[channel].count = 0;
+        }
+    }
+    _stats_windows[window] = storage;
+    return FDC1004_SUCCESS;
+}
+
+bool FDC1004::readWindowSummary(fdc1004_channel_t channel, uint8_t window, fdc1004_window_summary_t *summary)
+{
+    if (!isValidChannel(channel) || window >= FDC1004_STATS_WINDOWS || summary == nullptr)
+    {
+        return false;
+    }
+
+    fdc1004_stats_window_t *storage = _stats_windows[window];
+    if (storage == nullptr || !(storage->ready & (1 << channel)))
+    {
+        return false;
+    }
+
+    *summary = storage->summary[channel];
+    storage->ready &= ~(1 << channel);
+    return true;
+}
+
+// =============================================================================
+// Noise Characterisation
+// =============================================================================
+
+fdc1004_error_t FDC1004::characterizeNoise(fdc1004_channel_t channel, uint16_t conversions_per_rate,
+                                           fdc1004_noise_profile_t *profile)
+{
+    if (!_device_initialized || !isValidChannel(channel) ||
+        conversions_per_rate < FDC1004_NOISE_MIN_CONVERSIONS || profile == nullptr)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    fdc1004_sample_rate_t original_rate = _sample_rate;
+    uint8_t capdac = _capdac_values[channel];
+    fdc1004_error_t result = FDC1004_SUCCESS;
+
+    profile->channel = channel;
+    profile->capdac = capdac;
+    profile->conversions = conversions_per_rate;
+
+    for (uint8_t rate_index = 0; rate_index < 3 && result == FDC1004_SUCCESS; rate_index++)
+    {
+        _sample_rate = (fdc1004_sample_rate_t)(FDC1004_RATE_100HZ + rate_index);
+
+        // Per averaging depth: partial block sum, statistics of block means,
+        // and the sum of squared differences between consecutive block means
+        int64_t block_sum[FDC1004_NOISE_DEPTHS] = {0};
+        fdc1004_window_accumulator_t blocks[FDC1004_NOISE_DEPTHS];
+        int32_t previous_mean[FDC1004_NOISE_DEPTHS];
+        uint64_t allan_sum[FDC1004_NOISE_DEPTHS] = {0};
+        for (uint8_t depth = 0; depth < FDC1004_NOISE_DEPTHS; depth++)
+        {
+            blocks[depth].count = 0;
+        }
+
+        for (uint16_t conversion = 0; conversion < conversions_per_rate; conversion++)
+        {
+            uint16_t raw[2];
+            result = measureChannel(channel, capdac, raw);
+            if (result != FDC1004_SUCCESS)
+            {
+                break;
+            }
+
+            if ((int16_t)raw[0] > FDC1004_UPPER_BOUND || (int16_t)raw[0] < FDC1004_LOWER_BOUND)
+            {
+                autoAdjustCapdac(channel, (int16_t)raw[0]);
+                result = FDC1004_ERROR_CAPDAC_OUT_OF_RANGE;
+                break;
+            }
+
+            int64_t value_af = (int64_t)fdc1004_raw24(raw[0], raw[1]) * FDC1004_ATTOFARADS_UPPER_WORD / 256 +
+                               (int64_t)FDC1004_FEMTOFARADS_CAPDAC * 1000 * capdac;
+
+            for (uint8_t depth = 0; depth < FDC1004_NOISE_DEPTHS; depth++)
+            {
+                block_sum[depth] += value_af;
+                if (((conversion + 1) & ((1 << depth) - 1)) != 0)
+                {
+                    continue;
+                }
+
+                int32_t mean_af = (int32_t)(block_sum[depth] / (1 << depth));
+                block_sum[depth] = 0;
+
+                if (blocks[depth].count > 0)
+                {
+                    int64_t step = (int64_t)mean_af - previous_mean[depth];
+                    uint64_t term = (uint64_t)(step * step);
+                    allan_sum[depth] = (allan_sum[depth] + term < allan_sum[depth]) ? UINT64_MAX : allan_sum[depth] + term;
+                }
+                previous_mean[depth] = mean_af;
+                accumulateSample(&blocks[depth], mean_af);
+            }
+        }
+
+        for (uint8_t depth = 0; depth < FDC1004_NOISE_DEPTHS && result == FDC1004_SUCCESS; depth++)
+        {
+            fdc1004_noise_point_t *point = &profile->points[rate_index][depth];
+            point->stddev_af = sampleDeviation(&blocks[depth]);
+            point->allan_af = (blocks[depth].count > 1) ? squareRoot64(allan_sum[depth] / (2 * (blocks[depth].count - 1))) : 0;
+        }
+    }
+
+    _sample_rate = original_rate;
+    return result;
+}
+
+fdc1004_error_t FDC1004::selectAcquisitionConfig(const fdc1004_noise_profile_t *profile, float target_ff,
+                                                 fdc1004_acquisition_config_t *config) const
+{
+    if (profile == nullptr || config == nullptr || !(target_ff > 0.0f) ||
+        profile->conversions < FDC1004_NOISE_MIN_CONVERSIONS)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    uint32_t target_af = (target_ff >= 4.0e6f) ? UINT32_MAX : (uint32_t)(target_ff * 1000.0f);
+    bool found = false;
+
+    for (uint8_t rate_index = 0; rate_index < 3; rate_index++)
+    {
+        for (uint8_t depth = 0; depth < FDC1004_NOISE_DEPTHS; depth++)
+        {
+            const fdc1004_noise_point_t *point = &profile->points[rate_index][depth];
+            uint32_t noise_af = (point->allan_af > point->stddev_af) ? point->allan_af : point->stddev_af;
+            uint8_t averaging = 1 << depth;
+            if (noise_af > target_af)
+            {
+                continue;
+            }
+
+            // Depths are visited in ascending order, so the first one that
+            // meets the target is the cheapest for this rate
+            if (!found || averaging < config->averaging ||
+                (averaging == config->averaging && noise_af < config->noise_af))
+            {
+                config->rate = (fdc1004_sample_rate_t)(FDC1004_RATE_100HZ + rate_index);
+                config->averaging = averaging;
+                config->i2c_bytes = (uint16_t)averaging * FDC1004_I2C_BYTES_PER_CONVERSION;
+                config->period_us = averaging * CONVERSION_PERIODS_US[rate_index];
+                config->noise_af = noise_af;
+                found = true;
+            }
+            break;
+        }
+    }
+
+    return found ? FDC1004_SUCCESS : FDC1004_ERROR_INVALID_PARAMETER;
+}
+
+// =============================================================================
+// Published State
+// =============================================================================
+
+bool FDC1004::readPublishedState(fdc1004_published_t *state) const
+{
+    if (state == nullptr)
+    {
+        return false;
+    }
+
+    for (uint8_t attempt = 0; attempt < FDC1004_PUBLISH_READ_ATTEMPTS; attempt++)
+    {
+        uint32_t before = _publish_sequence;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (before & 1)
+        {
+            continue; // Update in progress
+        }
+
+        memcpy(state, (const void *)&_published, sizeof(*state));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (_publish_sequence == before)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// =============================================================================
+// Configuration and Control
+// =============================================================================
+
+fdc1004_error_t FDC1004::setSampleRate(fdc1004_sample_rate_t rate)
+{
+    if (!isValidSampleRate(rate))
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    _sample_rate = rate;
+    return FDC1004_SUCCESS;
+}
+
+fdc1004_sample_rate_t FDC1004::getSampleRate() const
+{
+    return _sample_rate;
+}
+
+fdc1004_error_t FDC1004::setCapdac(fdc1004_channel_t channel, uint8_t capdac)
+{
+    if (!isValidChannel(channel) || !isValidCapdac(capdac))
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    _capdac_values[channel] = capdac;
+    return FDC1004_SUCCESS;
+}
+
+uint8_t FDC1004::getCapdac(fdc1004_channel_t channel) const
+{
+    if (!isValidChannel(channel))
+    {
+        return 0;
+    }
+    return _capdac_values[channel];
+}
+
+fdc1004_error_t FDC1004::setOffsetCalibration(fdc1004_channel_t channel, uint16_t value)
+{
+    if (!isValidChannel(channel))
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    fdc1004_error_t result = writeRegister16(OFFSET_CALIBRATION_REGISTERS[channel], value);
+    if (result == FDC1004_SUCCESS)
+    {
+        _offset_cal[channel] = value;
+    }
+    return result;
+}
+
+fdc1004_error_t FDC1004::setGainCalibration(fdc1004_channel_t channel, uint16_t value)
+{
+    if (!isValidChannel(channel))
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    fdc1004_error_t result = writeRegister16(GAIN_CALIBRATION_REGISTERS[channel], value);
+    if (result == FDC1004_SUCCESS)
+    {
+        _gain_cal[channel] = value;
+    }
+    return result;
+}
+
+fdc1004_error_t FDC1004::exportState(fdc1004_state_t *state) const
+{
+    if (state == nullptr)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    // Clear padding so the checksum is reproducible
+    memset(state, 0, sizeof(*state));
+    state->version = FDC1004_STATE_VERSION;
+    state->sample_rate = (uint8_t)_sample_rate;
+    for (int i = 0; i < 4; i++)
+    {
+        state->capdac[i] = _capdac_values[i];
+        state->slot_config[i] = _slot_config[i];
+        state->offset_cal[i] = _offset_cal[i];
+        state->gain_cal[i] = _gain_cal[i];
+    }
+    state->checksum = stateChecksum(state);
+
+    return FDC1004_SUCCESS;
+}
+
+fdc1004_error_t FDC1004::importState(const fdc1004_state_t *state)
+{
+    if (state == nullptr ||
+        state->version != FDC1004_STATE_VERSION ||
+        state->checksum != stateChecksum(state) ||
+        !isValidSampleRate(state->sample_rate))
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (!isValidCapdac(state->capdac[i]))
+        {
+            return FDC1004_ERROR_INVALID_PARAMETER;
+        }
+    }
+
+    _sample_rate = (fdc1004_sample_rate_t)state->sample_rate;
+    for (int i = 0; i < 4; i++)
+    {
+        _capdac_values[i] = state->capdac[i];
+        _slot_config[i] = state->slot_config[i];
+        _offset_cal[i] = state->offset_cal[i];
+        _gain_cal[i] = state->gain_cal[i];
+    }
+
+    if (!_device_initialized)
+    {
+        return FDC1004_SUCCESS;
+    }
+
+    return writeStateRegisters();
+}
+
+// =============================================================================
+// Low-Level Hardware Interface (New Implementation)
+// =============================================================================
+
+fdc1004_error_t FDC1004::configureMeasurementSingle(fdc1004_measurement_t measurement,
+                                                    fdc1004_channel_t channel,
+                                                    uint8_t capdac)
+{
+    if (!isValidMeasurement(measurement) || !isValidChannel(channel) || !isValidCapdac(capdac))
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    // Build 16-bit configuration
+    uint16_t configuration_data = 0;
+    configuration_data |= ((uint16_t)channel) << FDC1004_CONF_MEAS_CHA_SHIFT;            // CHA
+    configuration_data |= FDC1004_CONF_MEAS_CHB_DISABLED << FDC1004_CONF_MEAS_CHB_SHIFT; // CHB disable
+    configuration_data |= ((uint16_t)capdac) << FDC1004_CONF_MEAS_CAPDAC_SHIFT;          // CAPDAC value
+
+    fdc1004_error_t result = writeRegister16(MEASUREMENT_CONFIG_REGISTERS[measurement], configuration_data);
+    if (result == FDC1004_SUCCESS)
+    {
+        _slot_config[measurement] = configuration_data;
+    }
+    return result;
+}
+
+fdc1004_error_t FDC1004::configureMeasurementDifferential(fdc1004_measurement_t measurement,
+                                                          fdc1004_channel_t positive,
+                                                          fdc1004_channel_t negative)
+{
+    if (!isValidMeasurement(measurement) || !isValidChannel(positive) || !isValidChannel(negative) ||
+        negative <= positive)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    // Build 16-bit configuration
+    uint16_t configuration_data = 0;
+    configuration_data |= ((uint16_t)positive) << FDC1004_CONF_MEAS_CHA_SHIFT; // CHA
+    configuration_data |= ((uint16_t)negative) << FDC1004_CONF_MEAS_CHB_SHIFT; // CHB
+
+    fdc1004_error_t result = writeRegister16(MEASUREMENT_CONFIG_REGISTERS[measurement], configuration_data);
+    if (result == FDC1004_SUCCESS)
+    {
+        _slot_config[measurement] = configuration_data;
+    }
+    return result;
+}
+
+fdc1004_error_t FDC1004::triggerSingleMeasurement(fdc1004_measurement_t measurement,
+                                                  fdc1004_sample_rate_t rate)
+{
+    if (!isValidMeasurement(measurement) || !isValidSampleRate(rate))
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    uint16_t trigger_data = 0;
+    trigger_data |= ((uint16_t)rate) << FDC1004_FDC_CONF_RATE_SHIFT; // Sample rate
+    trigger_data |= 0 << FDC1004_FDC_CONF_REPEAT_SHIFT;              // Repeat disabled
+    trigger_data |= (1 << (7 - measurement));                        // Enable measurement
+
+    fdc1004_error_t result = writeRegister16(FDC1004_REG_FDC_CONF, trigger_data);
+    if (result == FDC1004_SUCCESS)
+    {
+        _slot_timestamps_us[measurement] = micros() + CONVERSION_PERIODS_US[rate - FDC1004_SAMPLE_RATE_100HZ];
+    }
+    return result;
+}
+
+fdc1004_error_t FDC1004::triggerMeasurements(uint8_t measurement_mask, fdc1004_sample_rate_t rate)
+{
+    measurement_mask &= FDC1004_FDC_CONF_MEAS_MASK;
+    if (measurement_mask == 0 || !isValidSampleRate(rate))
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    uint16_t trigger_data = 0;
+    trigger_data |= ((uint16_t)rate) << FDC1004_FDC_CONF_RATE_SHIFT; // Sample rate
+    trigger_data |= 0 << FDC1004_FDC_CONF_REPEAT_SHIFT;              // Repeat disabled
+    for (uint8_t measurement = 0; measurement <= FDC1004_MEASUREMENT_MAX; measurement++)
+    {
+        if (measurement_mask & (1 << measurement))
+        {
+            trigger_data |= (1 << (7 - measurement));                // Enable measurement
+        }
+    }
+
+    fdc1004_error_t result = writeRegister16(FDC1004_REG_FDC_CONF, trigger_data);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    // Enabled slots are converted back to back in ascending order
+    uint32_t completion_us = micros();
+    uint32_t period_us = CONVERSION_PERIODS_US[rate - FDC1004_SAMPLE_RATE_100HZ];
+    for (uint8_t measurement = 0; measurement <= FDC1004_MEASUREMENT_MAX; measurement++)
+    {
+        if (measurement_mask & (1 << measurement))
+        {
+            completion_us += period_us;
+            _slot_timestamps_us[measurement] = completion_us;
+        }
+    }
+
+    return FDC1004_SUCCESS;
+}
+
+uint32_t FDC1004::getMeasurementTimestamp(fdc1004_measurement_t measurement) const
+{
+    if (!isValidMeasurement(measurement))
+    {
+        return 0;
+    }
+    return _slot_timestamps_us[measurement];
+}
+
+fdc1004_error_t FDC1004::readMeasurement(fdc1004_measurement_t measurement, uint16_t *value)
+{
+    if (!isValidMeasurement(measurement) || value == nullptr)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    // Check if measurement is complete
+    uint16_t fdc_register;
+    fdc1004_error_t result = readRegister16(FDC1004_REG_FDC_CONF, &fdc_register);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    if (!(fdc_register & (1 << (3 - measurement))))
+    {
+        return FDC1004_ERROR_MEASUREMENT_NOT_READY;
+    }
+
+    // Read the measurement values
+    const uint8_t registers[2] = {MEASUREMENT_MSB_REGISTERS[measurement],
+                                  MEASUREMENT_LSB_REGISTERS[measurement]};
+    return readRegisters16(registers, value, 2);
+}
+
+fdc1004_error_t FDC1004::measureChannel(fdc1004_channel_t channel, uint8_t capdac, uint16_t *value)
+{
+    if (!isValidChannel(channel) || !isValidCapdac(capdac) || value == nullptr)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    // Use measurement slot equal to channel number
+    fdc1004_measurement_t measurement = (fdc1004_measurement_t)channel;
+
+    fdc1004_error_t result = configureMeasurementSingle(measurement, channel, capdac);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    result = triggerSingleMeasurement(measurement, _sample_rate);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    delay(getMeasurementDelay());
+    return readMeasurement(measurement, value);
+}
+
+fdc1004_error_t FDC1004::getRawCapacitance(fdc1004_channel_t channel, fdc1004_raw_measurement_t *value)
+{
+    if (!isValidChannel(channel) || value == nullptr)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    uint8_t capdac = _capdac_values[channel];
     uint16_t raw_measurement[2];
 
     fdc1004_error_t result = measureChannel(channel, capdac, raw_measurement);
@@ -392,10 +1406,82 @@ uint16_t FDC1004::read16(uint8_t reg)
     return value;
 }
 
-// =============================================================================
-// Private Methods - I2C Communication
-// =============================================================================
+// =============================================================================
+// Private Methods - I2C Communication
+// =============================================================================
+
+#ifdef FDC1004_LINUX_I2CDEV
+// Issue one I2C_RDWR transfer; consecutive messages are joined by repeated starts
+static fdc1004_error_t transferMessages(int fd, fdc1004_ioctl_t handler, void *context,
+                                        struct i2c_msg *messages, uint8_t count)
+{
+    struct i2c_rdwr_ioctl_data transfer;
+    transfer.msgs = messages;
+    transfer.nmsgs = count;
+
+    int result = (handler != nullptr) ? handler(context, I2C_RDWR, &transfer)
+                                      : ioctl(fd, I2C_RDWR, &transfer);
+    return (result == (int)count) ? FDC1004_SUCCESS : FDC1004_ERROR_I2C_COMMUNICATION;
+}
+
+fdc1004_error_t FDC1004::writeRegister16(uint8_t reg, uint16_t data)
+{
+    uint8_t buffer[3] = {reg, (uint8_t)(data >> 8), (uint8_t)(data)}; // MSB first
+
+    struct i2c_msg message;
+    message.addr = _i2c_address;
+    message.flags = 0;
+    message.len = sizeof(buffer);
+    message.buf = buffer;
+
+    return transferMessages(_fd, _ioctl, _ioctl_context, &message, 1);
+}
+
+fdc1004_error_t FDC1004::readRegister16(uint8_t reg, uint16_t *data)
+{
+    return readRegisters16(&reg, data, 1);
+}
+
+fdc1004_error_t FDC1004::readRegisters16(const uint8_t *regs, uint16_t *data, uint8_t count)
+{
+    if (regs == nullptr || data == nullptr || count == 0 || count > FDC1004_MAX_BATCH_READ)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    // Pointer write followed by a 2-byte read for every register, all in one transfer
+    uint8_t pointers[FDC1004_MAX_BATCH_READ];
+    uint8_t buffers[FDC1004_MAX_BATCH_READ][2];
+    struct i2c_msg messages[FDC1004_MAX_BATCH_READ * 2];
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        pointers[i] = regs[i];
+
+        messages[2 * i].addr = _i2c_address;
+        messages[2 * i].flags = 0;
+        messages[2 * i].len = 1;
+        messages[2 * i].buf = &pointers[i];
+
+        messages[2 * i + 1].addr = _i2c_address;
+        messages[2 * i + 1].flags = I2C_M_RD;
+        messages[2 * i + 1].len = 2;
+        messages[2 * i + 1].buf = buffers[i];
+    }
+
+    fdc1004_error_t result = transferMessages(_fd, _ioctl, _ioctl_context, messages, count * 2);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
 
+    for (uint8_t i = 0; i < count; i++)
+    {
+        data[i] = ((uint16_t)buffers[i][0] << 8) | buffers[i][1];
+    }
+    return FDC1004_SUCCESS;
+}
+#else
 fdc1004_error_t FDC1004::writeRegister16(uint8_t reg, uint16_t data)
 {
     _wire->beginTransmission(_i2c_address);
@@ -433,16 +1519,168 @@ fdc1004_error_t FDC1004::readRegister16(uint8_t reg, uint16_t *data)
     return FDC1004_SUCCESS;
 }
 
+fdc1004_error_t FDC1004::readRegisters16(const uint8_t *regs, uint16_t *data, uint8_t count)
+{
+    if (regs == nullptr || data == nullptr || count == 0 || count > FDC1004_MAX_BATCH_READ)
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        fdc1004_error_t result = readRegister16(regs[i], &data[i]);
+        if (result != FDC1004_SUCCESS)
+        {
+            return result;
+        }
+    }
+    return FDC1004_SUCCESS;
+}
+#endif
+
 void FDC1004::write16(uint8_t reg, uint16_t data)
 {
     // Legacy function - ignore error handling
     writeRegister16(reg, data);
 }
 
+fdc1004_error_t FDC1004::initializeDevice()
+{
+#ifdef FDC1004_LINUX_I2CDEV
+    // Open the bus node unless transfers are routed to a custom handler
+    if (_ioctl == nullptr && _fd < 0)
+    {
+        _fd = open(_device_path, O_RDWR);
+        if (_fd < 0)
+        {
+            return FDC1004_ERROR_I2C_COMMUNICATION;
+        }
+    }
+#else
+    // Initialize the TwoWire interface
+    _wire->begin();
+#endif
+
+    // Check if the device is responding and is really an FDC1004
+    return verifyDeviceId();
+}
+
+fdc1004_error_t FDC1004::verifyDeviceId()
+{
+    uint16_t manufacturer_id;
+    fdc1004_error_t result = readRegister16(FDC1004_REG_MANUFACTURER_ID, &manufacturer_id);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    uint16_t device_id;
+    result = readRegister16(FDC1004_REG_DEVICE_ID, &device_id);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    if (manufacturer_id != FDC1004_MANUFACTURER_ID || device_id != FDC1004_DEVICE_ID)
+    {
+        return FDC1004_ERROR_DEVICE_NOT_FOUND;
+    }
+
+    return FDC1004_SUCCESS;
+}
+
+fdc1004_error_t FDC1004::readStateRegisters()
+{
+    fdc1004_error_t result = readRegisters16(MEASUREMENT_CONFIG_REGISTERS, _slot_config, 4);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    result = readRegisters16(OFFSET_CALIBRATION_REGISTERS, _offset_cal, 4);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    return readRegisters16(GAIN_CALIBRATION_REGISTERS, _gain_cal, 4);
+}
+
+fdc1004_error_t FDC1004::writeStateRegisters()
+{
+    for (int i = 0; i < 4; i++)
+    {
+        fdc1004_error_t result = writeRegister16(MEASUREMENT_CONFIG_REGISTERS[i], _slot_config[i]);
+        if (result != FDC1004_SUCCESS)
+        {
+            return result;
+        }
+
+        result = writeRegister16(OFFSET_CALIBRATION_REGISTERS[i], _offset_cal[i]);
+        if (result != FDC1004_SUCCESS)
+        {
+            return result;
+        }
+
+        result = writeRegister16(GAIN_CALIBRATION_REGISTERS[i], _gain_cal[i]);
+        if (result != FDC1004_SUCCESS)
+        {
+            return result;
+        }
+    }
+
+    return FDC1004_SUCCESS;
+}
+
 // =============================================================================
 // Private Methods - Utility Functions
 // =============================================================================
 
+void FDC1004::resetChannelState()
+{
+    _level_config.level_channel = FDC1004_CHANNEL_0;
+    _level_config.reference_channel = FDC1004_CHANNEL_1;
+    _level_config.environment_channel = FDC1004_CHANNEL_2;
+    _level_config.empty_level_af = 0;
+    _level_config.full_ratio = 1L << 16;
+    _level_config.full_scale = FDC1004_LEVEL_FULL_SCALE_DEFAULT;
+
+    _adaptive_enabled = false;
+    _adaptive_saved_rate = _sample_rate;
+    _adaptive_reference_valid = false;
+    _adaptive_state = FDC1004_ADAPTIVE_IDLE;
+    _adaptive_last_scan_ms = 0;
+    _adaptive_quiet_since_ms = 0;
+
+    _publish_sequence = 0;
+    _published.sequence = 0;
+
+    for (uint8_t window = 0; window < FDC1004_STATS_WINDOWS; window++)
+    {
+        _stats_windows[window] = nullptr;
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        _published.capacitance_pf[i] = NAN;
+        _published.raw[i].value = 0;
+        _published.raw[i].capdac = 0;
+        _published.timestamp_us[i] = 0;
+
+        _capdac_values[i] = 0;
+        _slot_config[i] = (i << FDC1004_CONF_MEAS_CHA_SHIFT) |
+                          (FDC1004_CONF_MEAS_CHB_DISABLED << FDC1004_CONF_MEAS_CHB_SHIFT);
+        _offset_cal[i] = FDC1004_OFFSET_CAL_DEFAULT;
+        _gain_cal[i] = FDC1004_GAIN_CAL_DEFAULT;
+        _slot_timestamps_us[i] = 0;
+        _latest_pf[i] = NAN;
+        _latest_us[i] = 0;
+        _previous_pf[i] = NAN;
+        _previous_us[i] = 0;
+        _sample_history[i] = 0;
+    }
+}
+
 uint8_t FDC1004::getMeasurementDelay() const
 {
     switch (_sample_rate)
@@ -458,14 +1696,340 @@ uint8_t FDC1004::getMeasurementDelay() const
     }
 }
 
-float FDC1004::convertToPicofarads(int16_t raw_value, uint8_t capdac) const
+fdc1004_error_t FDC1004::waitForMeasurements(uint8_t measurement_mask)
+{
+    uint16_t done_mask = 0;
+    for (uint8_t measurement = 0; measurement <= FDC1004_MEASUREMENT_MAX; measurement++)
+    {
+        if (measurement_mask & (1 << measurement))
+        {
+            done_mask |= (1 << (3 - measurement));
+        }
+    }
+
+    // Allow one extra measurement delay for oscillator tolerance before giving up
+    uint8_t retries = getMeasurementDelay();
+    while (true)
+    {
+        uint16_t fdc_register;
+        fdc1004_error_t result = readRegister16(FDC1004_REG_FDC_CONF, &fdc_register);
+        if (result != FDC1004_SUCCESS)
+        {
+            return result;
+        }
+
+        if ((fdc_register & done_mask) == done_mask)
+        {
+            return FDC1004_SUCCESS;
+        }
+
+        if (retries-- == 0)
+        {
+            return FDC1004_ERROR_MEASUREMENT_NOT_READY;
+        }
+        delay(1);
+    }
+}
+
+fdc1004_error_t FDC1004::scanChannels(uint8_t channel_mask, fdc1004_raw_measurement_t *results)
+{
+    uint8_t last_slot = 0;
+    for (uint8_t channel = 0; channel <= FDC1004_CHANNEL_MAX; channel++)
+    {
+        if (!(channel_mask & (1 << channel)))
+        {
+            continue;
+        }
+
+        fdc1004_error_t result = configureMeasurementSingle((fdc1004_measurement_t)channel,
+                                                            (fdc1004_channel_t)channel,
+                                                            _capdac_values[channel]);
+        if (result != FDC1004_SUCCESS)
+        {
+            return result;
+        }
+        last_slot = channel;
+    }
+
+    fdc1004_error_t result = triggerMeasurements(channel_mask, _sample_rate);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    // Slots finish in ascending order, so the highest one completes the scan
+    waitUntilMicros(_slot_timestamps_us[last_slot]);
+
+    result = waitForMeasurements(channel_mask);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    // Fetch every finished slot's MSB/LSB pair in one batch
+    uint8_t registers[8];
+    uint16_t values[8];
+    uint8_t count = 0;
+    for (uint8_t channel = 0; channel <= FDC1004_CHANNEL_MAX; channel++)
+    {
+        if (channel_mask & (1 << channel))
+        {
+            registers[count++] = MEASUREMENT_MSB_REGISTERS[channel];
+            registers[count++] = MEASUREMENT_LSB_REGISTERS[channel];
+        }
+    }
+
+    result = readRegisters16(registers, values, count);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    count = 0;
+    for (uint8_t channel = 0; channel <= FDC1004_CHANNEL_MAX; channel++)
+    {
+        if (!(channel_mask & (1 << channel)))
+        {
+            continue;
+        }
+
+        results[channel].value = (int16_t)values[count];
+        results[channel].capdac = _capdac_values[channel];
+        count += 2;
+
+        if (results[channel].value > FDC1004_UPPER_BOUND ||
+            results[channel].value < FDC1004_LOWER_BOUND)
+        {
+            autoAdjustCapdac((fdc1004_channel_t)channel, results[channel].value);
+        }
+    }
+
+    // Publish the whole scan as one consistent update
+    beginPublish();
+    for (uint8_t channel = 0; channel <= FDC1004_CHANNEL_MAX; channel++)
+    {
+        if (channel_mask & (1 << channel))
+        {
+            recordChannelSample((fdc1004_channel_t)channel, &results[channel], _slot_timestamps_us[channel]);
+        }
+    }
+    endPublish();
+
+    // Statistics are not published, so keep them out of the write section
+    for (uint8_t channel = 0; channel <= FDC1004_CHANNEL_MAX; channel++)
+    {
+        if (channel_mask & (1 << channel))
+        {
+            updateStatistics((fdc1004_channel_t)channel, &results[channel], _slot_timestamps_us[channel]);
+        }
+    }
+
+    return FDC1004_SUCCESS;
+}
+
+fdc1004_error_t FDC1004::buildSlotConfig(const fdc1004_logical_measurement_t *measurement, uint16_t *config) const
+{
+    if (!isValidChannel(measurement->positive))
+    {
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    uint16_t configuration_data = ((uint16_t)measurement->positive) << FDC1004_CONF_MEAS_CHA_SHIFT;
+    if (measurement->negative == FDC1004_CONF_MEAS_CHB_DISABLED)
+    {
+        if (!isValidCapdac(measurement->capdac))
+        {
+            return FDC1004_ERROR_INVALID_PARAMETER;
+        }
+        configuration_data |= FDC1004_CONF_MEAS_CHB_DISABLED << FDC1004_CONF_MEAS_CHB_SHIFT;
+        configuration_data |= ((uint16_t)measurement->capdac) << FDC1004_CONF_MEAS_CAPDAC_SHIFT;
+    }
+    else
+    {
+        if (!isValidChannel(measurement->negative) || measurement->negative <= measurement->positive)
+        {
+            return FDC1004_ERROR_INVALID_PARAMETER;
+        }
+        configuration_data |= ((uint16_t)measurement->negative) << FDC1004_CONF_MEAS_CHB_SHIFT;
+    }
+
+    *config = configuration_data;
+    return FDC1004_SUCCESS;
+}
+
+fdc1004_error_t FDC1004::loadSlotConfig(fdc1004_measurement_t measurement, uint16_t config)
+{
+    if (_slot_config[measurement] == config)
+    {
+        return FDC1004_SUCCESS;
+    }
+
+    fdc1004_error_t result = writeRegister16(MEASUREMENT_CONFIG_REGISTERS[measurement], config);
+    if (result == FDC1004_SUCCESS)
+    {
+        _slot_config[measurement] = config;
+    }
+    return result;
+}
+
+fdc1004_error_t FDC1004::scanLevelElectrodes(fdc1004_level_t *level)
 {
-    // Convert from raw measurement to picofarads
-    float capacitance_af = (float)FDC1004_ATTOFARADS_UPPER_WORD * (float)raw_value;  // attofarads
-    float capacitance_pf = capacitance_af / 1000000.0f;                              // Convert to picofarads
-    capacitance_pf += ((float)FDC1004_FEMTOFARADS_CAPDAC * (float)capdac) / 1000.0f; // Add CAPDAC offset
+    if (!_device_initialized)
+    {
+        return FDC1004_ERROR_DEVICE_NOT_FOUND;
+    }
+
+    uint8_t level_channel = _level_config.level_channel;
+    uint8_t reference_channel = _level_config.reference_channel;
+    uint8_t environment_channel = _level_config.environment_channel;
+
+    fdc1004_raw_measurement_t raw[4];
+    fdc1004_error_t result = scanChannels((1 << level_channel) | (1 << reference_channel) | (1 << environment_channel), raw);
+    if (result != FDC1004_SUCCESS)
+    {
+        return result;
+    }
+
+    level->capdac_out_of_range = false;
+    const uint8_t channels[3] = {level_channel, reference_channel, environment_channel};
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        if (raw[channels[i]].value > FDC1004_UPPER_BOUND || raw[channels[i]].value < FDC1004_LOWER_BOUND)
+        {
+            level->capdac_out_of_range = true;
+        }
+    }
+
+    level->level = 0;
+    level->level_af = fdc1004_raw_to_attofarads(raw[level_channel].value, raw[level_channel].capdac);
+    level->reference_af = fdc1004_raw_to_attofarads(raw[reference_channel].value, raw[reference_channel].capdac);
+    level->environment_af = fdc1004_raw_to_attofarads(raw[environment_channel].value, raw[environment_channel].capdac);
+
+    // Slots convert in ascending order, so the highest channel finished last
+    uint8_t last_channel = level_channel;
+    if (reference_channel > last_channel)
+    {
+        last_channel = reference_channel;
+    }
+    if (environment_channel > last_channel)
+    {
+        last_channel = environment_channel;
+    }
+    level->timestamp_us = _slot_timestamps_us[last_channel];
+
+    // Liquid response of the reference electrode normalises out the dielectric constant
+    int32_t reference_delta = level->reference_af - level->environment_af;
+    if (reference_delta <= 0)
+    {
+        level->ratio = 0;
+        return FDC1004_ERROR_INVALID_PARAMETER;
+    }
+
+    int32_t level_delta = level->level_af - _level_config.empty_level_af;
+    int64_t ratio = ((int64_t)level_delta * 65536) / reference_delta;
+    if (ratio > INT32_MAX)
+    {
+        ratio = INT32_MAX;
+    }
+    else if (ratio < INT32_MIN)
+    {
+        ratio = INT32_MIN;
+    }
+    level->ratio = (int32_t)ratio;
+    return FDC1004_SUCCESS;
+}
+
+void FDC1004::recordChannelSample(fdc1004_channel_t channel, const fdc1004_raw_measurement_t *raw, uint32_t timestamp_us)
+{
+    float capacitance_pf = convertToPicofarads(raw->value, raw->capdac);
 
-    return capacitance_pf;
+    _previous_pf[channel] = _latest_pf[channel];
+    _previous_us[channel] = _latest_us[channel];
+    _latest_pf[channel] = capacitance_pf;
+    _latest_us[channel] = timestamp_us;
+    if (_sample_history[channel] < 2)
+    {
+        _sample_history[channel]++;
+    }
+
+    _published.capacitance_pf[channel] = capacitance_pf;
+    _published.raw[channel] = *raw;
+    _published.timestamp_us[channel] = timestamp_us;
+}
+
+void FDC1004::updateStatistics(fdc1004_channel_t channel, const fdc1004_raw_measurement_t *raw, uint32_t timestamp_us)
+{
+    int32_t value_af = fdc1004_raw_to_attofarads(raw->value, raw->capdac);
+
+    for (uint8_t window = 0; window < FDC1004_STATS_WINDOWS; window++)
+    {
+        fdc1004_stats_window_t *storage = _stats_windows[window];
+        if (storage == nullptr)
+        {
+            continue;
+        }
+
+        uint32_t duration_us = storage->duration_us;
+        fdc1004_window_accumulator_t *current = &storage->current[channel];
+        if (current->count > 0 &&
+            (timestamp_us - current->start_us >= duration_us || current->count == 0xFFFF))
+        {
+            fdc1004_window_summary_t *summary = &storage->summary[channel];
+            summary->start_us = current->start_us;
+            summary->count = current->count;
+            summary->min_af = current->min_af;
+            summary->max_af = current->max_af;
+            summary->mean_af = sampleMean(current);
+            summary->stddev_af = sampleDeviation(current);
+            storage->ready |= 1 << channel;
+
+            // Keep windows on a fixed grid unless sampling stopped for a whole window
+            uint32_t next_start_us = current->start_us + duration_us;
+            if (timestamp_us - next_start_us >= duration_us)
+            {
+                next_start_us = timestamp_us;
+            }
+            current->count = 0;
+            current->start_us = next_start_us;
+        }
+        else if (current->count == 0)
+        {
+            current->start_us = timestamp_us;
+        }
+
+        accumulateSample(current, value_af);
+    }
+}
+
+void FDC1004::markAdaptiveReference(uint32_t now_ms)
+{
+    for (uint8_t channel = 0; channel <= FDC1004_CHANNEL_MAX; channel++)
+    {
+        _adaptive_reference_pf[channel] = _latest_pf[channel];
+        _adaptive_reference_us[channel] = _latest_us[channel];
+    }
+    _adaptive_reference_ms = now_ms;
+    _adaptive_reference_valid = true;
+}
+
+void FDC1004::beginPublish()
+{
+    // Odd sequence tells readers an update is in progress
+    _publish_sequence = _publish_sequence + 1;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void FDC1004::endPublish()
+{
+    _published.sequence = (_publish_sequence + 1) >> 1;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    _publish_sequence = _publish_sequence + 1;
+}
+
+float FDC1004::convertToPicofarads(int16_t raw_value, uint8_t capdac) const
+{
+    // Same conversion as the public batch routines, so host-side results match
+    return fdc1004_raw_to_picofarads(raw_value, capdac);
 }
 
 bool FDC1004::isValidChannel(uint8_t channel) const
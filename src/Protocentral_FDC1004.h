@@ -21,8 +21,20 @@
 #ifndef _FDC1004
 #define _FDC1004
 
+// Outside the Arduino environment on Linux, talk to the sensor through /dev/i2c-N
+#if !defined(FDC1004_LINUX_I2CDEV) && defined(__linux__) && !defined(ARDUINO)
+#define FDC1004_LINUX_I2CDEV
+#endif
+
+#ifdef FDC1004_LINUX_I2CDEV
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#else
 #include "Arduino.h"
 #include "Wire.h"
+#endif
+#include "Protocentral_FDC1004_Conversion.h"
 
 //Constants and limits for FDC1004
 #define FDC1004_100HZ (0x01)
@@ -40,6 +52,19 @@
 // I2C Address
 #define FDC1004_I2C_ADDRESS (0x50)
 
+#ifdef FDC1004_LINUX_I2CDEV
+// Default i2c-dev bus node
+#define FDC1004_LINUX_I2C_DEVICE "/dev/i2c-1"
+
+/**
+ * @brief ioctl replacement for the Linux backend
+ * 
+ * Receives the same request and argument as ioctl(2) would (always I2C_RDWR
+ * with a struct i2c_rdwr_ioctl_data*) and returns ioctl's result convention.
+ */
+typedef int (*fdc1004_ioctl_t)(void* context, unsigned long request, void* arg);
+#endif
+
 // Register addresses
 #define FDC1004_REG_MEAS1_MSB (0x00)
 #define FDC1004_REG_MEAS1_LSB (0x01)
@@ -54,8 +79,50 @@
 #define FDC1004_REG_CONF_MEAS3 (0x0A)
 #define FDC1004_REG_CONF_MEAS4 (0x0B)
 #define FDC1004_REG_FDC_CONF (0x0C)
+#define FDC1004_REG_OFFSET_CAL_CIN1 (0x0D)
+#define FDC1004_REG_OFFSET_CAL_CIN2 (0x0E)
+#define FDC1004_REG_OFFSET_CAL_CIN3 (0x0F)
+#define FDC1004_REG_OFFSET_CAL_CIN4 (0x10)
+#define FDC1004_REG_GAIN_CAL_CIN1 (0x11)
+#define FDC1004_REG_GAIN_CAL_CIN2 (0x12)
+#define FDC1004_REG_GAIN_CAL_CIN3 (0x13)
+#define FDC1004_REG_GAIN_CAL_CIN4 (0x14)
+#define FDC1004_REG_MANUFACTURER_ID (0xFE)
 #define FDC1004_REG_DEVICE_ID (0xFF)
 
+// Identification register contents
+#define FDC1004_MANUFACTURER_ID (0x5449)
+#define FDC1004_DEVICE_ID (0x1004)
+
+// Calibration register power-on defaults
+#define FDC1004_OFFSET_CAL_DEFAULT (0x0000)
+#define FDC1004_GAIN_CAL_DEFAULT (0x4000)
+
+// Default level reported for a full tank (0.1% steps)
+#define FDC1004_LEVEL_FULL_SCALE_DEFAULT (1000)
+
+// Attempts readPublishedState() makes before reporting a torn read
+#define FDC1004_PUBLISH_READ_ATTEMPTS (16)
+
+// Rolling statistics windows that can be attached at once
+#ifndef FDC1004_STATS_WINDOWS
+#define FDC1004_STATS_WINDOWS (2)
+#endif
+#define FDC1004_STATS_MAX_WINDOW_MS (3600000UL) // window timing uses 32-bit micros()
+
+// Noise characterisation: averaging depths 1, 2, 4, ... FDC1004_NOISE_MAX_AVERAGING
+#define FDC1004_NOISE_DEPTHS (5)
+#define FDC1004_NOISE_MAX_AVERAGING (1 << (FDC1004_NOISE_DEPTHS - 1))
+#define FDC1004_NOISE_MIN_BLOCKS (32) // block means needed at the deepest averaging for a usable deviation
+#define FDC1004_NOISE_MIN_CONVERSIONS (FDC1004_NOISE_MAX_AVERAGING * FDC1004_NOISE_MIN_BLOCKS)
+
+// Bus bytes per single-channel conversion, address bytes included: slot
+// configuration write (4), trigger write (4), status read (5), MSB and LSB reads (10)
+#define FDC1004_I2C_BYTES_PER_CONVERSION (23)
+
+// Layout version of fdc1004_state_t
+#define FDC1004_STATE_VERSION (0x01)
+
 // Configuration bit shifts
 #define FDC1004_CONF_MEAS_CHA_SHIFT (13)
 #define FDC1004_CONF_MEAS_CHB_SHIFT (10)
@@ -64,20 +131,19 @@
 
 #define FDC1004_FDC_CONF_RATE_SHIFT (10)
 #define FDC1004_FDC_CONF_REPEAT_SHIFT (8)
+#define FDC1004_FDC_CONF_MEAS_MASK (0x0F)
 
 // Measurement bounds for CAPDAC adjustment
 #define FDC1004_UPPER_BOUND (0x4000)
 #define FDC1004_LOWER_BOUND (-0x4000)
 
-// Conversion constants
-#define FDC1004_ATTOFARADS_UPPER_WORD (457)
-#define FDC1004_FEMTOFARADS_CAPDAC (3028)
-
 #define FDC1004_CAPDAC_MAX (0x1F)
 #define FDC1004_CHANNEL_MAX (0x03)
 #define FDC1004_MEASUREMENT_MAX (0x03)
 #define FDC1004_IS_CHANNEL(x) (x >= 0 && x <= FDC1004_CHANNEL_MAX)
 
+#define FDC1004_MAX_BATCH_READ (8)
+
 #define FDC1004_MEAS_MAX (0x03)
 #define FDC1004_IS_MEAS(x) (x >= 0 && x <= FDC1004_MEAS_MAX)
 
@@ -148,6 +214,197 @@ typedef struct {
     uint8_t capdac_used;        ///< CAPDAC value used for measurement
 } fdc1004_capacitance_t;
 
+/**
+ * @brief Latest per-channel measurements published by the acquisition path
+ */
+typedef struct {
+    float capacitance_pf[4];                ///< Latest capacitance per channel (NaN until measured)
+    fdc1004_raw_measurement_t raw[4];       ///< Latest raw value and CAPDAC per channel
+    uint32_t timestamp_us[4];               ///< Conversion completion time per channel (micros())
+    uint32_t sequence;                      ///< Number of updates published so far
+} fdc1004_published_t;
+
+/**
+ * @brief Persistent driver state for warm starts
+ * 
+ * Plain data that can be written to EEPROM or flash as is. The checksum is
+ * filled in by exportState() and verified by importState().
+ */
+typedef struct {
+    uint8_t version;            ///< Layout version (FDC1004_STATE_VERSION)
+    uint8_t sample_rate;        ///< Sample rate (fdc1004_sample_rate_t)
+    uint8_t capdac[4];          ///< CAPDAC value per channel
+    uint16_t slot_config[4];    ///< CONF_MEAS1-4 register contents
+    uint16_t offset_cal[4];     ///< OFFSET_CAL_CIN1-4 register contents
+    uint16_t gain_cal[4];       ///< GAIN_CAL_CIN1-4 register contents
+    uint16_t checksum;          ///< Fletcher-16 checksum of the preceding fields
+} fdc1004_state_t;
+
+/**
+ * @brief Policy used to align sequential conversions to a common timestamp
+ */
+typedef enum {
+    FDC1004_ALIGN_LINEAR = 0,       ///< Linear interpolation between consecutive conversions
+    FDC1004_ALIGN_SAMPLE_HOLD       ///< Latest conversion at or before the common timestamp
+} fdc1004_align_policy_t;
+
+/**
+ * @brief Multi-channel capacitance snapshot aligned to a single timestamp
+ */
+typedef struct {
+    float capacitance_pf[4];    ///< Aligned capacitance per channel in picofarads (NaN if not scanned)
+    uint8_t capdac_used[4];     ///< CAPDAC value used for the latest conversion of each channel
+    uint8_t channel_mask;       ///< Channels included in the snapshot (bit n = channel n)
+    uint32_t timestamp_us;      ///< Common timestamp all channels are aligned to (micros())
+    uint32_t skew_us;           ///< Spread between first and last slot conversion that was corrected
+} fdc1004_snapshot_t;
+
+/**
+ * @brief One logical measurement for the measurement sequencer
+ */
+typedef struct {
+    fdc1004_channel_t positive; ///< CHA input channel
+    uint8_t negative;           ///< CHB input channel for differential (must be above CHA), or FDC1004_CONF_MEAS_CHB_DISABLED for single-ended
+    uint8_t capdac;             ///< CAPDAC offset for single-ended measurements (0-31)
+} fdc1004_logical_measurement_t;
+
+/**
+ * @brief Result of one logical measurement from the measurement sequencer
+ */
+typedef struct {
+    int32_t value;              ///< Signed 24-bit measurement result
+    float capacitance_pf;       ///< Capacitance in picofarads, including the CAPDAC offset
+    uint32_t timestamp_us;      ///< Estimated conversion completion time (micros())
+} fdc1004_sequence_result_t;
+
+/**
+ * @brief Electrode assignment and calibration for ratiometric liquid level
+ * 
+ * Level is computed as in TI's three-electrode method: the level electrode's
+ * change from empty is divided by the reference electrode's liquid response
+ * (reference minus environment), then scaled by the same ratio at full.
+ */
+typedef struct {
+    fdc1004_channel_t level_channel;        ///< Electrode spanning the measured height
+    fdc1004_channel_t reference_channel;    ///< Electrode that is always submerged
+    fdc1004_channel_t environment_channel;  ///< Electrode that is never submerged
+    int32_t empty_level_af;                 ///< Level electrode capacitance with the tank empty (aF)
+    int32_t full_ratio;                     ///< Level ratio with the tank full (Q16)
+    uint16_t full_scale;                    ///< Level reported for a full tank (e.g. height in mm)
+} fdc1004_level_config_t;
+
+/**
+ * @brief Liquid level result from one coordinated scan
+ */
+typedef struct {
+    uint16_t level;             ///< Level from 0 to full_scale
+    int32_t ratio;              ///< Uncalibrated level ratio (Q16)
+    int32_t level_af;           ///< Level electrode capacitance (aF)
+    int32_t reference_af;       ///< Reference electrode capacitance (aF)
+    int32_t environment_af;     ///< Environment electrode capacitance (aF)
+    bool capdac_out_of_range;   ///< True if an electrode needed a CAPDAC adjustment
+    uint32_t timestamp_us;      ///< Completion time of the scan (micros())
+} fdc1004_level_t;
+
+/**
+ * @brief Acquisition state of the adaptive sampling mode
+ */
+typedef enum {
+    FDC1004_ADAPTIVE_IDLE = 0,      ///< Slow cadence at the idle sample rate
+    FDC1004_ADAPTIVE_ACTIVE         ///< Back-to-back scans at 400 Hz
+} fdc1004_adaptive_state_t;
+
+/**
+ * @brief Configuration for adaptive sampling
+ * 
+ * Activity is measured as the per-channel rate of change against a reference
+ * scan taken idle_interval_ms earlier, in both modes. With noise sigma per
+ * reading, the noise floor is about 1.4 * sigma / idle_interval. The quiet
+ * threshold should be below the activity threshold, and both above that
+ * floor, to give hysteresis between the two modes.
+ */
+typedef struct {
+    uint8_t channel_mask;                   ///< Channels to scan, bit n = channel n
+    fdc1004_sample_rate_t idle_rate;        ///< Sample rate while idle
+    uint16_t idle_interval_ms;              ///< Time between scans while idle
+    uint16_t active_interval_ms;            ///< Time between scans while active (0 = back to back)
+    uint32_t activity_threshold_ff_per_s;   ///< Rate of change on any channel that starts a burst
+    uint32_t quiet_threshold_ff_per_s;      ///< Rate of change all channels must stay below to count as quiet
+    uint16_t quiet_hold_ms;                 ///< Quiet time required before returning to idle
+} fdc1004_adaptive_config_t;
+
+/**
+ * @brief Statistics of one channel over one completed window
+ * 
+ * Values are in attofarads, including the CAPDAC offset, so a window stays
+ * consistent across CAPDAC adjustments.
+ */
+typedef struct {
+    uint32_t start_us;          ///< Start of the window (micros())
+    uint16_t count;             ///< Samples in the window
+    int32_t min_af;             ///< Smallest sample (aF)
+    int32_t max_af;             ///< Largest sample (aF)
+    int32_t mean_af;            ///< Mean (aF)
+    uint32_t stddev_af;         ///< Sample standard deviation (aF), UINT32_MAX if the sums saturated
+} fdc1004_window_summary_t;
+
+/**
+ * @brief Running accumulator for the window currently being filled
+ * 
+ * Samples are summed exactly as offsets from the first sample, so the mean
+ * and deviation carry no rounding drift however many samples are added.
+ */
+typedef struct {
+    uint64_t sum_squares;       ///< Sum of squared offsets (aF^2), saturating
+    int64_t sum;                ///< Sum of offsets (aF)
+    uint32_t start_us;          ///< Start of the window (micros())
+    int32_t offset_af;          ///< First sample, subtracted from every sample (aF)
+    int32_t min_af;             ///< Smallest sample so far (aF)
+    int32_t max_af;             ///< Largest sample so far (aF)
+    uint16_t count;             ///< Samples so far, 0 before the first sample
+} fdc1004_window_accumulator_t;
+
+/**
+ * @brief Caller-owned storage for one rolling statistics window on all channels
+ * 
+ * Only attached windows take RAM; keep the storage alive while attached.
+ */
+typedef struct {
+    uint32_t duration_us;                       ///< Window length
+    fdc1004_window_accumulator_t current[4];    ///< Window being filled, per channel
+    fdc1004_window_summary_t summary[4];        ///< Last completed window, per channel
+    uint8_t ready;                              ///< Unread summaries, bit n = channel n
+} fdc1004_stats_window_t;
+
+/**
+ * @brief Measured noise of one sample rate and averaging depth
+ */
+typedef struct {
+    uint32_t stddev_af;         ///< Standard deviation of the averaged outputs (aF)
+    uint32_t allan_af;          ///< Allan deviation between consecutive averaged outputs (aF)
+} fdc1004_noise_point_t;
+
+/**
+ * @brief Noise of one channel for every sample rate and averaging depth
+ */
+typedef struct {
+    fdc1004_channel_t channel;  ///< Characterised channel
+    uint8_t capdac;             ///< CAPDAC used during characterisation
+    uint16_t conversions;       ///< Conversions captured per sample rate
+    fdc1004_noise_point_t points[3][FDC1004_NOISE_DEPTHS]; ///< [rate - FDC1004_RATE_100HZ][log2(averaging)]
+} fdc1004_noise_profile_t;
+
+/**
+ * @brief Acquisition configuration chosen from a noise profile
+ */
+typedef struct {
+    fdc1004_sample_rate_t rate; ///< Sample rate to use
+    uint8_t averaging;          ///< Conversions to average per output sample
+    uint16_t i2c_bytes;         ///< Bus bytes per output sample
+    uint32_t period_us;         ///< Conversion time per output sample
+    uint32_t noise_af;          ///< Expected noise: the larger of stddev and Allan deviation (aF)
+} fdc1004_acquisition_config_t;
+
 // =============================================================================
 // FDC1004 Class Declaration
 // =============================================================================
@@ -174,6 +431,43 @@ public:
     // Constructors and Initialization
     // =========================================================================
     
+#ifdef FDC1004_LINUX_I2CDEV
+    /**
+     * @brief Constructor with sample rate specification
+     * @param rate Sample rate for measurements (default: 100Hz)
+     * @param address I2C address (default: 0x50)
+     * @param device i2c-dev bus node to use (default: /dev/i2c-1)
+     */
+    FDC1004(fdc1004_sample_rate_t rate = FDC1004_RATE_100HZ, uint8_t address = FDC1004_I2C_ADDRESS, const char* device = FDC1004_LINUX_I2C_DEVICE);
+    
+    /**
+     * @brief Constructor with i2c-dev bus node specification
+     * @param device i2c-dev bus node to use, e.g. "/dev/i2c-1"
+     * @param rate Sample rate for measurements (default: 100Hz)
+     * @param address I2C address (default: 0x50)
+     */
+    FDC1004(const char* device, fdc1004_sample_rate_t rate = FDC1004_RATE_100HZ, uint8_t address = FDC1004_I2C_ADDRESS);
+    
+    /**
+     * @brief Close the i2c-dev bus node if it was opened by begin()
+     */
+    ~FDC1004();
+    
+    // The destructor owns the bus descriptor, so copies would close it twice
+    FDC1004(const FDC1004&) = delete;
+    FDC1004& operator=(const FDC1004&) = delete;
+    
+    /**
+     * @brief Route I2C transfers through a custom ioctl handler
+     * 
+     * Intended for testing without hardware. With a handler installed begin()
+     * does not open the bus node. Pass nullptr to restore the real ioctl.
+     * 
+     * @param handler ioctl replacement
+     * @param context Opaque pointer passed to the handler
+     */
+    void setIoctlHandler(fdc1004_ioctl_t handler, void* context);
+#else
     /**
      * @brief Constructor with sample rate specification
      * @param rate Sample rate for measurements (default: 100Hz)
@@ -190,6 +484,8 @@ public:
      */
     FDC1004(TwoWire* wire, fdc1004_sample_rate_t rate = FDC1004_RATE_100HZ, uint8_t address = FDC1004_I2C_ADDRESS);
     
+#endif
+    
     /**
      * @brief Legacy constructor for backward compatibility
      * @param rate Sample rate as uint16_t
@@ -202,6 +498,19 @@ public:
      */
     bool begin();
     
+    /**
+     * @brief Initialize the FDC1004 sensor and restore previously exported state
+     * 
+     * Verifies the manufacturer and device ID, then restores CAPDAC, sample rate,
+     * slot configuration and calibration registers in one pass, so the first
+     * conversion after wake-up is already in range. A state that fails
+     * validation is ignored and the sensor starts cold.
+     * 
+     * @param state State previously filled by exportState()
+     * @return true if initialization successful, false otherwise
+     */
+    bool begin(const fdc1004_state_t* state);
+    
     /**
      * @brief Check if device is connected and responding
      * @return true if device is responding, false otherwise
@@ -233,6 +542,227 @@ public:
      */
     int32_t getCapacitance(uint8_t channel = 1);
     
+    /**
+     * @brief Scan several channels and align them to one common timestamp
+     * 
+     * All requested channels are converted in a single triggered sequence. The
+     * FDC1004 converts slots one after another, so each result is timestamped
+     * with its own slot completion time and then interpolated (or held) to the
+     * completion time of the first slot in the scan. The first snapshot after
+     * begin() has no earlier conversion to interpolate from and is returned as is.
+     * 
+     * @param snapshot Pointer to store the aligned snapshot
+     * @param policy Alignment policy (default: linear interpolation)
+     * @param channel_mask Channels to scan, bit n = channel n (default: all)
+     * @return Error code
+     */
+    fdc1004_error_t getAlignedSnapshot(fdc1004_snapshot_t* snapshot,
+                                       fdc1004_align_policy_t policy = FDC1004_ALIGN_LINEAR,
+                                       uint8_t channel_mask = FDC1004_FDC_CONF_MEAS_MASK);
+    
+    /**
+     * @brief Run a list of logical measurements through the four hardware slots
+     * 
+     * The slots are triggered as one sequence. As soon as a slot finishes, its
+     * result is read and the slot is reprogrammed with the next pending entry
+     * while the remaining slots are still converting, so I2C traffic overlaps
+     * conversion time. Slot configurations that are already loaded are not
+     * rewritten. CAPDAC is not auto-adjusted for sequenced measurements.
+     * 
+     * @param measurements Logical measurements, converted in list order
+     * @param count Number of entries
+     * @param results Array of count entries to store the results
+     * @return Error code
+     */
+    fdc1004_error_t runSequence(const fdc1004_logical_measurement_t* measurements,
+                                uint8_t count,
+                                fdc1004_sequence_result_t* results);
+    
+    // =========================================================================
+    // Liquid Level
+    // =========================================================================
+    
+    /**
+     * @brief Set electrode assignment and calibration for level measurement
+     * @param config Level configuration; the three channels must differ
+     * @return Error code
+     */
+    fdc1004_error_t setLevelConfig(const fdc1004_level_config_t* config);
+    
+    /**
+     * @brief Get the level configuration, including calibration points
+     * @return Current level configuration
+     */
+    fdc1004_level_config_t getLevelConfig() const;
+    
+    /**
+     * @brief Record the empty-tank calibration point from one scan
+     * 
+     * Only the level electrode reading is used, so the reference electrode
+     * does not need to be covered.
+     * 
+     * @return Error code
+     */
+    fdc1004_error_t calibrateLevelEmpty();
+    
+    /**
+     * @brief Record the full-tank calibration point from one scan
+     * 
+     * Call after calibrateLevelEmpty().
+     * 
+     * @return Error code
+     */
+    fdc1004_error_t calibrateLevelFull();
+    
+    /**
+     * @brief Scan the three level electrodes together and compute the level
+     * 
+     * The electrodes are converted in one triggered sequence. The level is
+     * computed in integer arithmetic, so it can be published at the scan rate.
+     * 
+     * @param level Pointer to store the result
+     * @return Error code; FDC1004_ERROR_INVALID_PARAMETER if the reference
+     *         electrode does not read above the environment electrode
+     */
+    fdc1004_error_t updateLevel(fdc1004_level_t* level);
+    
+    // =========================================================================
+    // Adaptive Sampling
+    // =========================================================================
+    
+    /**
+     * @brief Enable or disable adaptive sampling
+     * 
+     * While idle the sensor is scanned every idle_interval_ms at idle_rate.
+     * When any channel changes faster than the activity threshold it switches
+     * to back-to-back scans at 400 Hz, keeping the converter busy (a
+     * four-channel scan about every 10 ms), until the signal has been quiet for
+     * quiet_hold_ms. In both modes the rate of change is taken over at least
+     * idle_interval_ms, so both thresholds see the same noise floor. Events
+     * shorter than the idle interval can only be seen if they leave a change
+     * behind at the next idle scan. The caller's sample rate is restored when
+     * disabled.
+     * 
+     * @param config Configuration to use, or nullptr to disable
+     * @return Error code
+     */
+    fdc1004_error_t setAdaptiveSampling(const fdc1004_adaptive_config_t* config);
+    
+    /**
+     * @brief Run a scan if one is due and update the acquisition state
+     * 
+     * Call this from the main loop. When no scan is due it returns
+     * FDC1004_ERROR_MEASUREMENT_NOT_READY without touching the bus.
+     * 
+     * @param snapshot Pointer to store the time-aligned scan result
+     * @return Error code
+     */
+    fdc1004_error_t updateAdaptive(fdc1004_snapshot_t* snapshot);
+    
+    /**
+     * @brief Get the time until the next adaptive scan is due
+     * @return Milliseconds the caller may sleep before calling updateAdaptive()
+     */
+    uint32_t getAdaptiveDelayMs() const;
+    
+    /**
+     * @brief Get the current adaptive acquisition state
+     * @return Idle or active
+     */
+    fdc1004_adaptive_state_t getAdaptiveState() const;
+    
+    // =========================================================================
+    // Window Statistics
+    // =========================================================================
+    
+    /**
+     * @brief Attach a rolling statistics window
+     * 
+     * Every sample recorded by a measurement or scan is added to each attached
+     * window of its channel in O(1). When a sample arrives after the window
+     * has ended, the window's summary is stored for readWindowSummary() and a
+     * new window starts at the boundary. A window also closes early after
+     * 65535 samples. Resets the window's accumulators.
+     * 
+     * @param window Window index (0 to FDC1004_STATS_WINDOWS-1)
+     * @param duration_ms Window length in milliseconds
+     * @param storage Storage for the window, or nullptr to detach it
+     * @return Error code
+     */
+    fdc1004_error_t setStatisticsWindow(uint8_t window, uint32_t duration_ms, fdc1004_stats_window_t* storage);
+    
+    /**
+     * @brief Get the summary of the last completed window
+     * 
+     * Call this from the acquisition task; it is not covered by the
+     * published-state sequence lock.
+     * 
+     * @param channel Channel to read
+     * @param window Window index
+     * @param summary Pointer to store the summary
+     * @return true if a window completed since the last call for this channel and window
+     */
+    bool readWindowSummary(fdc1004_channel_t channel, uint8_t window, fdc1004_window_summary_t* summary);
+    
+    // =========================================================================
+    // Noise Characterisation
+    // =========================================================================
+    
+    /**
+     * @brief Measure channel noise at every sample rate and averaging depth
+     * 
+     * Captures back-to-back conversions of the channel at its current CAPDAC
+     * through the single-channel measurement path, once per sample rate. For
+     * each averaging depth the conversions are split into consecutive blocks
+     * whose means give the standard deviation and the Allan deviation. Uses
+     * the full 24-bit result. Each conversion waits the single-measurement
+     * delay (11, 11 and 6 ms at 100, 200 and 400 Hz), so 512 conversions per
+     * rate block the caller for about 15 s; keep the electrodes in a steady
+     * state meanwhile. The sample rate is restored afterwards.
+     * 
+     * @param channel Channel to characterise
+     * @param conversions_per_rate Conversions per sample rate (at least FDC1004_NOISE_MIN_CONVERSIONS);
+     *        the deviations come from exact integer sums, so longer runs only add accuracy
+     * @param profile Pointer to store the measured noise
+     * @return Error code; FDC1004_ERROR_CAPDAC_OUT_OF_RANGE if the reading is
+     *         out of range, in which case CAPDAC has been adjusted and the call
+     *         can be repeated
+     */
+    fdc1004_error_t characterizeNoise(fdc1004_channel_t channel, uint16_t conversions_per_rate,
+                                      fdc1004_noise_profile_t* profile);
+    
+    /**
+     * @brief Choose the cheapest acquisition configuration for a target resolution
+     * 
+     * Picks the configuration with the fewest conversions (and so I2C bytes)
+     * per output sample whose standard deviation and Allan deviation are both
+     * within the target. Ties go to the lower noise.
+     * 
+     * @param profile Noise profile from characterizeNoise()
+     * @param target_ff Required resolution in femtofarads
+     * @param config Pointer to store the chosen configuration
+     * @return Error code; FDC1004_ERROR_INVALID_PARAMETER if no configuration meets the target
+     */
+    fdc1004_error_t selectAcquisitionConfig(const fdc1004_noise_profile_t* profile, float target_ff,
+                                            fdc1004_acquisition_config_t* config) const;
+    
+    // =========================================================================
+    // Published State
+    // =========================================================================
+    
+    /**
+     * @brief Copy the latest published measurements without touching the bus
+     * 
+     * Every successful channel measurement or scan publishes its results
+     * through a sequence lock. Any number of readers on other tasks or cores
+     * may call this concurrently with a single acquisition task. Readers never
+     * block the sampler: a copy that overlaps an update is retried.
+     * 
+     * @param state Pointer to store a consistent copy
+     * @return true on success, false if every attempt overlapped an update
+     */
+    bool readPublishedState(fdc1004_published_t* state) const;
+    
     // =========================================================================
     // Configuration and Control
     // =========================================================================
@@ -265,6 +795,40 @@ public:
      */
     uint8_t getCapdac(fdc1004_channel_t channel) const;
     
+    /**
+     * @brief Set the offset calibration register for a channel
+     * @param channel Channel number (0-3)
+     * @param value OFFSET_CAL_CINx register contents
+     * @return Error code
+     */
+    fdc1004_error_t setOffsetCalibration(fdc1004_channel_t channel, uint16_t value);
+    
+    /**
+     * @brief Set the gain calibration register for a channel
+     * @param channel Channel number (0-3)
+     * @param value GAIN_CAL_CINx register contents
+     * @return Error code
+     */
+    fdc1004_error_t setGainCalibration(fdc1004_channel_t channel, uint16_t value);
+    
+    /**
+     * @brief Export CAPDAC, sample rate, slot configuration and calibration
+     * @param state Pointer to store the state
+     * @return Error code
+     */
+    fdc1004_error_t exportState(fdc1004_state_t* state) const;
+    
+    /**
+     * @brief Import state previously filled by exportState()
+     * 
+     * The state is validated before anything is changed. If the sensor is
+     * already initialized the restored registers are written to the device.
+     * 
+     * @param state State to restore
+     * @return Error code
+     */
+    fdc1004_error_t importState(const fdc1004_state_t* state);
+    
     // =========================================================================
     // Low-Level Hardware Interface
     // =========================================================================
@@ -280,6 +844,17 @@ public:
                                                fdc1004_channel_t channel, 
                                                uint8_t capdac);
     
+    /**
+     * @brief Configure a differential measurement
+     * @param measurement Measurement slot (0-3)
+     * @param positive Positive input channel (0-2)
+     * @param negative Negative input channel, above the positive channel (1-3)
+     * @return Error code
+     */
+    fdc1004_error_t configureMeasurementDifferential(fdc1004_measurement_t measurement,
+                                                     fdc1004_channel_t positive,
+                                                     fdc1004_channel_t negative);
+    
     /**
      * @brief Trigger a single measurement
      * @param measurement Measurement slot to trigger
@@ -289,6 +864,21 @@ public:
     fdc1004_error_t triggerSingleMeasurement(fdc1004_measurement_t measurement, 
                                              fdc1004_sample_rate_t rate);
     
+    /**
+     * @brief Trigger several measurement slots in one sequence
+     * @param measurement_mask Slots to convert, bit n = measurement slot n
+     * @param rate Sample rate for the conversions
+     * @return Error code
+     */
+    fdc1004_error_t triggerMeasurements(uint8_t measurement_mask, fdc1004_sample_rate_t rate);
+    
+    /**
+     * @brief Get the estimated completion time of the last conversion in a slot
+     * @param measurement Measurement slot
+     * @return Timestamp in microseconds (micros() time base)
+     */
+    uint32_t getMeasurementTimestamp(fdc1004_measurement_t measurement) const;
+    
     /**
      * @brief Read measurement result
      * @param measurement Measurement slot to read
@@ -333,8 +923,43 @@ private:
     uint8_t _i2c_address;               ///< I2C device address
     fdc1004_sample_rate_t _sample_rate; ///< Current sample rate
     uint8_t _capdac_values[4];          ///< Current CAPDAC values for each channel
+    uint16_t _slot_config[4];           ///< Last written CONF_MEAS1-4 register contents
+    uint16_t _offset_cal[4];            ///< Last written OFFSET_CAL_CIN1-4 register contents
+    uint16_t _gain_cal[4];              ///< Last written GAIN_CAL_CIN1-4 register contents
     bool _device_initialized;           ///< Initialization status
+#ifdef FDC1004_LINUX_I2CDEV
+    const char* _device_path;           ///< i2c-dev bus node
+    int _fd;                            ///< Open file descriptor for the bus node, -1 if closed
+    fdc1004_ioctl_t _ioctl;             ///< Custom ioctl handler, nullptr to use ioctl(2)
+    void* _ioctl_context;               ///< Context passed to the custom ioctl handler
+#else
     TwoWire* _wire;                     ///< TwoWire interface for I2C communication
+#endif
+    
+    uint32_t _slot_timestamps_us[4];    ///< Estimated completion time of each slot's last conversion
+    float _latest_pf[4];                ///< Latest capacitance per channel
+    uint32_t _latest_us[4];             ///< Conversion time of the latest sample per channel
+    float _previous_pf[4];              ///< Previous capacitance per channel
+    uint32_t _previous_us[4];           ///< Conversion time of the previous sample per channel
+    uint8_t _sample_history[4];         ///< Number of stored samples per channel (0-2)
+    
+    volatile uint32_t _publish_sequence;        ///< Sequence lock counter, odd while an update is in progress
+    fdc1004_published_t _published;             ///< Latest published measurements
+    
+    fdc1004_level_config_t _level_config;       ///< Level electrodes and calibration
+    
+    bool _adaptive_enabled;                     ///< Adaptive sampling active
+    fdc1004_adaptive_config_t _adaptive_config; ///< Adaptive sampling configuration
+    fdc1004_adaptive_state_t _adaptive_state;   ///< Current adaptive acquisition state
+    fdc1004_sample_rate_t _adaptive_saved_rate; ///< Caller's sample rate, restored when adaptive sampling is disabled
+    uint32_t _adaptive_last_scan_ms;            ///< Start time of the last adaptive scan
+    uint32_t _adaptive_quiet_since_ms;          ///< Start of the current quiet period while active
+    bool _adaptive_reference_valid;             ///< Reference scan recorded
+    uint32_t _adaptive_reference_ms;            ///< Start time of the reference scan
+    float _adaptive_reference_pf[4];            ///< Capacitance per channel at the reference scan
+    uint32_t _adaptive_reference_us[4];         ///< Conversion time per channel at the reference scan
+    
+    fdc1004_stats_window_t* _stats_windows[FDC1004_STATS_WINDOWS]; ///< Attached statistics windows, nullptr if unused
     
     // =========================================================================
     // Private Methods - I2C Communication
@@ -356,6 +981,19 @@ private:
      */
     fdc1004_error_t readRegister16(uint8_t reg, uint16_t* data);
     
+    /**
+     * @brief Read several 16-bit registers
+     * 
+     * On Linux all pointer-write + read pairs go out as one I2C_RDWR transfer
+     * joined by repeated starts.
+     * 
+     * @param regs Register addresses
+     * @param data Array to store read data
+     * @param count Number of registers (1-FDC1004_MAX_BATCH_READ)
+     * @return Error code
+     */
+    fdc1004_error_t readRegisters16(const uint8_t* regs, uint16_t* data, uint8_t count);
+    
     /**
      * @brief Legacy I2C write function
      * @param reg Register address
@@ -363,16 +1001,127 @@ private:
      */
     void write16(uint8_t reg, uint16_t data);
     
+    /**
+     * @brief Bring up the bus and verify the device identity
+     * @return Error code
+     */
+    fdc1004_error_t initializeDevice();
+    
+    /**
+     * @brief Check the manufacturer and device ID registers
+     * @return Error code
+     */
+    fdc1004_error_t verifyDeviceId();
+    
+    /**
+     * @brief Load slot configuration and calibration shadows from the device
+     * @return Error code
+     */
+    fdc1004_error_t readStateRegisters();
+    
+    /**
+     * @brief Write slot configuration and calibration shadows to the device
+     * @return Error code
+     */
+    fdc1004_error_t writeStateRegisters();
+    
     // =========================================================================
     // Private Methods - Utility Functions
     // =========================================================================
     
+    /**
+     * @brief Reset per-channel state to power-on defaults
+     */
+    void resetChannelState();
+    
     /**
      * @brief Get measurement delay for current sample rate
      * @return Delay in milliseconds
      */
     uint8_t getMeasurementDelay() const;
     
+    /**
+     * @brief Poll the FDC configuration register until all given slots are done
+     * @param measurement_mask Slots to wait for, bit n = measurement slot n
+     * @return Error code
+     */
+    fdc1004_error_t waitForMeasurements(uint8_t measurement_mask);
+    
+    /**
+     * @brief Convert several channels in one triggered sequence
+     * 
+     * Channel n is measured in slot n with its current CAPDAC value. CAPDAC is
+     * auto-adjusted for channels that end up out of range.
+     * 
+     * @param channel_mask Channels to measure, bit n = channel n
+     * @param results Array of 4 entries, filled for the channels in the mask
+     * @return Error code
+     */
+    fdc1004_error_t scanChannels(uint8_t channel_mask, fdc1004_raw_measurement_t* results);
+    
+    /**
+     * @brief Build the CONF_MEASx register contents for a logical measurement
+     * @param measurement Logical measurement
+     * @param config Pointer to store the register contents
+     * @return Error code
+     */
+    fdc1004_error_t buildSlotConfig(const fdc1004_logical_measurement_t* measurement, uint16_t* config) const;
+    
+    /**
+     * @brief Write a slot configuration unless the slot already holds it
+     * @param measurement Measurement slot
+     * @param config CONF_MEASx register contents
+     * @return Error code
+     */
+    fdc1004_error_t loadSlotConfig(fdc1004_measurement_t measurement, uint16_t config);
+    
+    /**
+     * @brief Scan the level electrodes and compute the uncalibrated ratio
+     * @param level Pointer to store the result; level field is not filled
+     * @return Error code; FDC1004_ERROR_INVALID_PARAMETER if the reference
+     *         electrode shows no liquid response, in which case the electrode
+     *         readings are still filled in
+     */
+    fdc1004_error_t scanLevelElectrodes(fdc1004_level_t* level);
+    
+    /**
+     * @brief Store a converted sample in the alignment history and published state
+     * 
+     * Must be called between beginPublish() and endPublish().
+     * 
+     * @param channel Channel number
+     * @param raw Raw measurement and CAPDAC
+     * @param timestamp_us Conversion completion time
+     */
+    void recordChannelSample(fdc1004_channel_t channel, const fdc1004_raw_measurement_t* raw, uint32_t timestamp_us);
+    
+    /**
+     * @brief Add a sample to the enabled statistics windows of a channel
+     * 
+     * Call after endPublish(); the statistics are not part of the published state.
+     * 
+     * @param channel Channel number
+     * @param raw Raw measurement and CAPDAC
+     * @param timestamp_us Conversion completion time
+     */
+    void updateStatistics(fdc1004_channel_t channel, const fdc1004_raw_measurement_t* raw, uint32_t timestamp_us);
+    
+    /**
+     * @brief Take the latest scan as the reference for adaptive activity
+     * @param now_ms Start time of that scan (millis())
+     */
+    void markAdaptiveReference(uint32_t now_ms);
+    
+    /**
+     * @brief Open a published-state update (sequence lock write side)
+     */
+    void beginPublish();
+    
+    /**
+     * @brief Close a published-state update
+     */
+    void endPublish();
+    
     /**
      * @brief Convert raw measurement to picofarads
      * @param raw_value Raw measurement value
@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//    Capacitance conversion routines for the FDC1004 capacitance sensor
+//
+//    Author: Ashwin Whitchurch
+//    Copyright (c) 2018 ProtoCentral
+//
+//    This software is licensed under the MIT License(http://opensource.org/licenses/MIT).
+//
+//   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+//   NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//   For information on how to use, visit https://github.com/protocentral/ProtoCentral_fdc1004_breakout
+/////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Protocentral_FDC1004_Conversion.h"
+
+void fdc1004_convert_picofarads(const int16_t *FDC1004_RESTRICT raw,
+                                const uint8_t *FDC1004_RESTRICT capdac,
+                                float *FDC1004_RESTRICT picofarads,
+                                size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        picofarads[i] = (float)raw[i] * FDC1004_PICOFARADS_PER_LSB +
+                        (float)capdac[i] * FDC1004_PICOFARADS_PER_CAPDAC;
+    }
+}
+
+void fdc1004_convert_femtofarads(const int16_t *FDC1004_RESTRICT raw,
+                                 const uint8_t *FDC1004_RESTRICT capdac,
+                                 int32_t *FDC1004_RESTRICT femtofarads,
+                                 size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        femtofarads[i] = ((int32_t)FDC1004_ATTOFARADS_UPPER_WORD * (int32_t)raw[i]) / 1000 +
+                         (int32_t)FDC1004_FEMTOFARADS_CAPDAC * (int32_t)capdac[i];
+    }
+}
+
+void fdc1004_convert24_picofarads(const int32_t *FDC1004_RESTRICT raw24,
+                                  const uint8_t *FDC1004_RESTRICT capdac,
+                                  float *FDC1004_RESTRICT picofarads,
+                                  size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        picofarads[i] = (float)raw24[i] * FDC1004_PICOFARADS_PER_LSB24 +
+                        (float)capdac[i] * FDC1004_PICOFARADS_PER_CAPDAC;
+    }
+}
+
+void fdc1004_convert24_femtofarads(const int32_t *FDC1004_RESTRICT raw24,
+                                   const uint8_t *FDC1004_RESTRICT capdac,
+                                   int32_t *FDC1004_RESTRICT femtofarads,
+                                   size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        // Halve before scaling so 457 * raw24 cannot overflow 32 bits; the
+        // dropped bit is below 1 aF and far below the femtofarad output resolution
+        femtofarads[i] = ((raw24[i] >> 1) * (int32_t)FDC1004_ATTOFARADS_UPPER_WORD) / 128000 +
+                         (int32_t)FDC1004_FEMTOFARADS_CAPDAC * (int32_t)capdac[i];
+    }
+}
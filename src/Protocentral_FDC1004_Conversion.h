@@ -0,0 +1,165 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//    Capacitance conversion routines for the FDC1004 capacitance sensor
+//
+//    Author: Ashwin Whitchurch
+//    Copyright (c) 2018 ProtoCentral
+//
+//    This header has no Arduino dependencies, so host-side tools (gateways,
+//    log processors) can compile it together with its .cpp file directly.
+//
+//    This software is licensed under the MIT License(http://opensource.org/licenses/MIT).
+//
+//   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+//   NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//   For information on how to use, visit https://github.com/protocentral/ProtoCentral_fdc1004_breakout
+/////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _FDC1004_CONVERSION
+#define _FDC1004_CONVERSION
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Conversion constants
+#define FDC1004_ATTOFARADS_UPPER_WORD (457)
+#define FDC1004_FEMTOFARADS_CAPDAC (3028)
+
+#define FDC1004_PICOFARADS_PER_LSB (FDC1004_ATTOFARADS_UPPER_WORD * 1.0e-6f)        // per LSB of the upper 16 bits
+#define FDC1004_PICOFARADS_PER_LSB24 (FDC1004_ATTOFARADS_UPPER_WORD * 1.0e-6f / 256) // per LSB of the 24-bit result
+#define FDC1004_PICOFARADS_PER_CAPDAC (FDC1004_FEMTOFARADS_CAPDAC * 1.0e-3f)
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FDC1004_RESTRICT __restrict__
+#elif defined(_MSC_VER)
+#define FDC1004_RESTRICT __restrict
+#else
+#define FDC1004_RESTRICT
+#endif
+
+// =============================================================================
+// Single-Sample Conversion
+// =============================================================================
+
+/**
+ * @brief Assemble the signed 24-bit result from the MEASx_MSB/MEASx_LSB registers
+ * @param msb MEASx_MSB register contents
+ * @param lsb MEASx_LSB register contents (lower 8 bits are reserved)
+ * @return Signed 24-bit measurement value
+ */
+static inline int32_t fdc1004_raw24(uint16_t msb, uint16_t lsb)
+{
+    return ((int32_t)(((uint32_t)msb << 16) | lsb)) >> 8;
+}
+
+/**
+ * @brief Convert a 16-bit measurement value to picofarads
+ * @param raw Upper 16 bits of the measurement
+ * @param capdac CAPDAC value used for the measurement
+ * @return Capacitance in picofarads
+ */
+static inline float fdc1004_raw_to_picofarads(int16_t raw, uint8_t capdac)
+{
+    return (float)raw * FDC1004_PICOFARADS_PER_LSB + (float)capdac * FDC1004_PICOFARADS_PER_CAPDAC;
+}
+
+/**
+ * @brief Convert a 16-bit measurement value to femtofarads
+ * @param raw Upper 16 bits of the measurement
+ * @param capdac CAPDAC value used for the measurement
+ * @return Capacitance in femtofarads
+ */
+static inline int32_t fdc1004_raw_to_femtofarads(int16_t raw, uint8_t capdac)
+{
+    return ((int32_t)FDC1004_ATTOFARADS_UPPER_WORD * (int32_t)raw) / 1000 +
+           (int32_t)FDC1004_FEMTOFARADS_CAPDAC * (int32_t)capdac;
+}
+
+/**
+ * @brief Convert a 16-bit measurement value to attofarads
+ * @param raw Upper 16 bits of the measurement
+ * @param capdac CAPDAC value used for the measurement
+ * @return Capacitance in attofarads
+ */
+static inline int32_t fdc1004_raw_to_attofarads(int16_t raw, uint8_t capdac)
+{
+    return (int32_t)FDC1004_ATTOFARADS_UPPER_WORD * (int32_t)raw +
+           (int32_t)FDC1004_FEMTOFARADS_CAPDAC * 1000 * (int32_t)capdac;
+}
+
+/**
+ * @brief Convert a 24-bit measurement value to picofarads
+ * @param raw24 Signed 24-bit measurement value (see fdc1004_raw24())
+ * @param capdac CAPDAC value used for the measurement
+ * @return Capacitance in picofarads
+ */
+static inline float fdc1004_raw24_to_picofarads(int32_t raw24, uint8_t capdac)
+{
+    return (float)raw24 * FDC1004_PICOFARADS_PER_LSB24 + (float)capdac * FDC1004_PICOFARADS_PER_CAPDAC;
+}
+
+// =============================================================================
+// Batch Conversion
+// =============================================================================
+//
+// The batch functions are branch-free loops over independent elements with
+// non-aliasing arguments, so the auto-vectoriser can turn them into SSE/AVX/NEON
+// code on hosts; on microcontrollers they stay plain loops. GCC 12 vectorises
+// them at -O3 (or -O2 -ftree-vectorize -fvect-cost-model=dynamic) but not at
+// plain -O2; add -march=native for AVX. Results are identical to the
+// single-sample functions above. extras/host/conversion_benchmark.cpp measures
+// the speedup.
+
+/**
+ * @brief Convert 16-bit measurement values to picofarads
+ * @param raw Upper 16 bits of each measurement
+ * @param capdac CAPDAC value used for each measurement
+ * @param picofarads Output array
+ * @param count Number of samples
+ */
+void fdc1004_convert_picofarads(const int16_t* FDC1004_RESTRICT raw,
+                                const uint8_t* FDC1004_RESTRICT capdac,
+                                float* FDC1004_RESTRICT picofarads,
+                                size_t count);
+
+/**
+ * @brief Convert 16-bit measurement values to femtofarads
+ * @param raw Upper 16 bits of each measurement
+ * @param capdac CAPDAC value used for each measurement
+ * @param femtofarads Output array
+ * @param count Number of samples
+ */
+void fdc1004_convert_femtofarads(const int16_t* FDC1004_RESTRICT raw,
+                                 const uint8_t* FDC1004_RESTRICT capdac,
+                                 int32_t* FDC1004_RESTRICT femtofarads,
+                                 size_t count);
+
+/**
+ * @brief Convert 24-bit measurement values to picofarads
+ * @param raw24 Signed 24-bit measurement values (see fdc1004_raw24())
+ * @param capdac CAPDAC value used for each measurement
+ * @param picofarads Output array
+ * @param count Number of samples
+ */
+void fdc1004_convert24_picofarads(const int32_t* FDC1004_RESTRICT raw24,
+                                  const uint8_t* FDC1004_RESTRICT capdac,
+                                  float* FDC1004_RESTRICT picofarads,
+                                  size_t count);
+
+/**
+ * @brief Convert 24-bit measurement values to femtofarads
+ * @param raw24 Signed 24-bit measurement values (see fdc1004_raw24())
+ * @param capdac CAPDAC value used for each measurement
+ * @param femtofarads Output array
+ * @param count Number of samples
+ */
+void fdc1004_convert24_femtofarads(const int32_t* FDC1004_RESTRICT raw24,
+                                   const uint8_t* FDC1004_RESTRICT capdac,
+                                   int32_t* FDC1004_RESTRICT femtofarads,
+                                   size_t count);
+
+#endif // _FDC1004_CONVERSION
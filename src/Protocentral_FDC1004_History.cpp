@@ -0,0 +1,332 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//    Compressed sample history for the FDC1004 capacitance sensor
+//
+//    Author: Ashwin Whitchurch
+//    Copyright (c) 2018 ProtoCentral
+//
+//    This software is licensed under the MIT License(http://opensource.org/licenses/MIT).
+//
+//   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+//   NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//   For information on how to use, visit https://github.com/protocentral/ProtoCentral_fdc1004_breakout
+/////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Protocentral_FDC1004_History.h"
+#include <string.h>
+
+// =============================================================================
+// Private Constants
+// =============================================================================
+
+// Block header layout: frame count, then used size in nibbles (little endian)
+#define BLOCK_FRAME_COUNT (0)
+#define BLOCK_USED_LOW (1)
+#define BLOCK_USED_HIGH (2)
+
+#define BLOCK_NIBBLES (FDC1004_HISTORY_BLOCK_SIZE * 2)
+#define HEADER_NIBBLES (FDC1004_HISTORY_BLOCK_HEADER * 2)
+
+// Variable-length codes carry 3 payload bits per nibble plus a continuation bit
+#define NIBBLE_CONTINUE (0x8)
+#define NIBBLE_PAYLOAD (0x7)
+
+// A non-canonical code (continuation with zero payload, then a zero nibble)
+// the encoder never produces; marks a CAPDAC change
+#define CAPDAC_ESCAPE_0 (0x8)
+#define CAPDAC_ESCAPE_1 (0x0)
+
+static uint16_t getUsedNibbles(const uint8_t *block)
+{
+    return (uint16_t)block[BLOCK_USED_LOW] | ((uint16_t)block[BLOCK_USED_HIGH] << 8);
+}
+
+static void setUsedNibbles(uint8_t *block, uint16_t nibbles)
+{
+    block[BLOCK_USED_LOW] = (uint8_t)nibbles;
+    block[BLOCK_USED_HIGH] = (uint8_t)(nibbles >> 8);
+}
+
+static uint8_t readNibble(const uint8_t *block, uint16_t position)
+{
+    uint8_t byte = block[position >> 1];
+    return (position & 1) ? (byte & 0x0F) : (byte >> 4);
+}
+
+static void writeNibble(uint8_t *block, uint16_t position, uint8_t nibble)
+{
+    uint8_t *byte = &block[position >> 1];
+    if (position & 1)
+    {
+        *byte = (*byte & 0xF0) | (nibble & 0x0F);
+    }
+    else
+    {
+        *byte = (*byte & 0x0F) | (uint8_t)(nibble << 4);
+    }
+}
+
+// =============================================================================
+// Constructors and Initialization
+// =============================================================================
+
+FDC1004History::FDC1004History(uint8_t *arena, size_t size, uint8_t channel_count)
+    : _arena(arena), _channel_count(channel_count)
+{
+    size_t blocks = size / FDC1004_HISTORY_BLOCK_SIZE;
+    _block_count = (blocks > 0xFFFF) ? 0xFFFF : (uint16_t)blocks;
+    clear();
+}
+
+bool FDC1004History::isValid() const
+{
+    return (_arena != nullptr && _block_count >= 2 &&
+            _channel_count >= 1 && _channel_count <= FDC1004_HISTORY_MAX_CHANNELS);
+}
+
+// =============================================================================
+// Storage
+// =============================================================================
+
+bool FDC1004History::append(const fdc1004_history_frame_t *frame)
+{
+    if (!isValid() || frame == nullptr)
+    {
+        return false;
+    }
+
+    uint8_t encoded[FDC1004_HISTORY_MAX_FRAME_NIBBLES];
+    uint8_t length;
+    uint8_t *current = nullptr;
+    uint16_t used = 0;
+
+    // Try to extend the newest block with a delta frame
+    if (_next_block != _first_block)
+    {
+        current = block(_next_block - 1);
+        used = getUsedNibbles(current);
+        length = encodeFrame(frame, false, encoded);
+        if (current[BLOCK_FRAME_COUNT] == 0xFF || used + length > BLOCK_NIBBLES)
+        {
+            current = nullptr;
+        }
+    }
+
+    // Otherwise start a new block with a keyframe, evicting the oldest block if needed
+    if (current == nullptr)
+    {
+        if (_next_block - _first_block == _block_count)
+        {
+            _frame_count -= block(_first_block)[BLOCK_FRAME_COUNT];
+            _first_block++;
+        }
+
+        current = block(_next_block++);
+        current[BLOCK_FRAME_COUNT] = 0;
+        used = HEADER_NIBBLES;
+        length = encodeFrame(frame, true, encoded);
+    }
+
+    for (uint8_t i = 0; i < length; i++)
+    {
+        writeNibble(current, used + i, encoded[i]);
+    }
+    setUsedNibbles(current, used + length);
+    current[BLOCK_FRAME_COUNT]++;
+
+    _last = *frame;
+    _frame_count++;
+    return true;
+}
+
+void FDC1004History::rewind()
+{
+    _read_block = _first_block;
+    _read_offset = HEADER_NIBBLES;
+    _read_frame = 0;
+}
+
+bool FDC1004History::readNext(fdc1004_history_frame_t *frame)
+{
+    if (!isValid() || frame == nullptr)
+    {
+        return false;
+    }
+
+    // The block under the cursor was evicted; resume at the oldest one
+    if (_read_block < _first_block)
+    {
+        rewind();
+    }
+
+    while (_read_block < _next_block)
+    {
+        const uint8_t *current = block(_read_block);
+        if (_read_frame < current[BLOCK_FRAME_COUNT])
+        {
+            bool keyframe = (_read_frame == 0);
+            uint8_t consumed = decodeFrame(current, _read_offset, getUsedNibbles(current), keyframe, &_read_last);
+            if (consumed == 0)
+            {
+                return false;
+            }
+
+            _read_offset += consumed;
+            _read_frame++;
+            *frame = _read_last;
+            return true;
+        }
+
+        // Stay on the newest block so frames appended later are picked up
+        if (_read_block + 1 == _next_block)
+        {
+            return false;
+        }
+
+        _read_block++;
+        _read_offset = HEADER_NIBBLES;
+        _read_frame = 0;
+    }
+
+    return false;
+}
+
+void FDC1004History::clear()
+{
+    _first_block = 0;
+    _next_block = 0;
+    _frame_count = 0;
+    memset(&_last, 0, sizeof(_last));
+    memset(&_read_last, 0, sizeof(_read_last));
+    rewind();
+}
+
+uint32_t FDC1004History::getFrameCount() const
+{
+    return _frame_count;
+}
+
+size_t FDC1004History::getUsedBytes() const
+{
+    size_t used = 0;
+    for (uint32_t sequence = _first_block; sequence != _next_block; sequence++)
+    {
+        used += (getUsedNibbles(block(sequence)) + 1) / 2;
+    }
+    return used;
+}
+
+// =============================================================================
+// Private Methods - Encoding
+// =============================================================================
+
+uint8_t *FDC1004History::block(uint32_t sequence) const
+{
+    return _arena + (size_t)(sequence % _block_count) * FDC1004_HISTORY_BLOCK_SIZE;
+}
+
+uint8_t FDC1004History::encodeFrame(const fdc1004_history_frame_t *frame, bool keyframe, uint8_t *out) const
+{
+    uint8_t length = 0;
+
+    for (uint8_t channel = 0; channel < _channel_count; channel++)
+    {
+        if (keyframe)
+        {
+            uint16_t value = (uint16_t)frame->value[channel];
+            for (int8_t shift = 12; shift >= 0; shift -= 4)
+            {
+                out[length++] = (value >> shift) & 0x0F;
+            }
+            out[length++] = frame->capdac[channel] >> 4;
+            out[length++] = frame->capdac[channel] & 0x0F;
+            continue;
+        }
+
+        if (frame->capdac[channel] != _last.capdac[channel])
+        {
+            out[length++] = CAPDAC_ESCAPE_0;
+            out[length++] = CAPDAC_ESCAPE_1;
+            out[length++] = frame->capdac[channel] >> 4;
+            out[length++] = frame->capdac[channel] & 0x0F;
+        }
+
+        // Zigzag maps small negative and positive deltas to small codes
+        int32_t delta = (int32_t)frame->value[channel] - (int32_t)_last.value[channel];
+        uint32_t code = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+        while (code > NIBBLE_PAYLOAD)
+        {
+            out[length++] = (uint8_t)(code & NIBBLE_PAYLOAD) | NIBBLE_CONTINUE;
+            code >>= 3;
+        }
+        out[length++] = (uint8_t)code;
+    }
+
+    return length;
+}
+
+uint8_t FDC1004History::decodeFrame(const uint8_t *data, uint16_t position, uint16_t end, bool keyframe,
+                                    fdc1004_history_frame_t *frame) const
+{
+    uint16_t start = position;
+
+    for (uint8_t channel = 0; channel < _channel_count; channel++)
+    {
+        if (keyframe)
+        {
+            if (position + 6 > end)
+            {
+                return 0;
+            }
+
+            uint16_t value = 0;
+            for (uint8_t i = 0; i < 4; i++)
+            {
+                value = (value << 4) | readNibble(data, position++);
+            }
+            frame->value[channel] = (int16_t)value;
+            frame->capdac[channel] = (readNibble(data, position) << 4) | readNibble(data, position + 1);
+            position += 2;
+            continue;
+        }
+
+        if (position + 2 <= end &&
+            readNibble(data, position) == CAPDAC_ESCAPE_0 &&
+            readNibble(data, position + 1) == CAPDAC_ESCAPE_1)
+        {
+            if (position + 4 > end)
+            {
+                return 0;
+            }
+            frame->capdac[channel] = (readNibble(data, position + 2) << 4) | readNibble(data, position + 3);
+            position += 4;
+        }
+
+        uint32_t code = 0;
+        uint8_t shift = 0;
+        while (true)
+        {
+            if (position >= end || shift > 18)
+            {
+                return 0;
+            }
+
+            uint8_t nibble = readNibble(data, position++);
+            code |= (uint32_t)(nibble & NIBBLE_PAYLOAD) << shift;
+            shift += 3;
+            if (!(nibble & NIBBLE_CONTINUE))
+            {
+                break;
+            }
+        }
+
+        int32_t delta = (int32_t)(code >> 1) ^ -(int32_t)(code & 1);
+        frame->value[channel] = (int16_t)((int32_t)frame->value[channel] + delta);
+    }
+
+    return (uint8_t)(position - start);
+}
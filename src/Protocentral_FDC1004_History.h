@@ -0,0 +1,164 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//    Compressed sample history for the FDC1004 capacitance sensor
+//
+//    Author: Ashwin Whitchurch
+//    Copyright (c) 2018 ProtoCentral
+//
+//    This header has no Arduino dependencies, so the encoder and decoder can
+//    also be built on a host to unpack uploaded history.
+//
+//    This software is licensed under the MIT License(http://opensource.org/licenses/MIT).
+//
+//   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+//   NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//   For information on how to use, visit https://github.com/protocentral/ProtoCentral_fdc1004_breakout
+/////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _FDC1004_HISTORY
+#define _FDC1004_HISTORY
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Size of one arena block; the oldest block is evicted as a unit
+#define FDC1004_HISTORY_BLOCK_SIZE (128)
+#define FDC1004_HISTORY_BLOCK_HEADER (3)
+#define FDC1004_HISTORY_MAX_CHANNELS (4)
+#define FDC1004_HISTORY_MAX_FRAME_NIBBLES (FDC1004_HISTORY_MAX_CHANNELS * 10) // escape + CAPDAC + 6-nibble delta per channel
+
+/**
+ * @brief One history entry: raw reading and CAPDAC for each stored channel
+ */
+typedef struct {
+    int16_t value[FDC1004_HISTORY_MAX_CHANNELS];    ///< Raw measurement value per channel
+    uint8_t capdac[FDC1004_HISTORY_MAX_CHANNELS];   ///< CAPDAC used per channel
+} fdc1004_history_frame_t;
+
+/**
+ * @brief Delta-encoded sample history in a fixed circular byte arena
+ * 
+ * The arena is split into FDC1004_HISTORY_BLOCK_SIZE byte blocks. Each block
+ * starts with a full keyframe; later frames store per-channel differences as
+ * zigzag variable-length integers in 4-bit groups, so a channel whose reading
+ * moves by less than +/-4 counts costs half a byte per sample. A CAPDAC change
+ * is marked with an escape sequence. When the arena is full the oldest block
+ * is dropped. Appending is O(1).
+ * 
+ * Example usage:
+ * @code
+ * static uint8_t arena[2048];
+ * FDC1004History history(arena, sizeof(arena), 4);
+ * history.append(&frame);
+ * 
+ * history.rewind();
+ * while (history.readNext(&frame)) {
+ *     upload(frame);
+ * }
+ * history.clear();
+ * @endcode
+ */
+class FDC1004History {
+public:
+    /**
+     * @brief Constructor
+     * @param arena Storage for the history; must outlive the object
+     * @param size Arena size in bytes (at least two blocks)
+     * @param channel_count Channels stored per frame (1-4)
+     */
+    FDC1004History(uint8_t* arena, size_t size, uint8_t channel_count = FDC1004_HISTORY_MAX_CHANNELS);
+    
+    /**
+     * @brief Check that the arena and channel count are usable
+     * @return true if append() can store frames
+     */
+    bool isValid() const;
+    
+    /**
+     * @brief Append one frame, evicting the oldest block if the arena is full
+     * @param frame Frame to store; only the first channel_count channels are used
+     * @return true if stored
+     */
+    bool append(const fdc1004_history_frame_t* frame);
+    
+    /**
+     * @brief Move the read cursor to the oldest stored frame
+     */
+    void rewind();
+    
+    /**
+     * @brief Decode the frame at the read cursor and advance
+     * 
+     * If the block under the cursor was evicted by later appends, reading
+     * resumes at the oldest remaining frame.
+     * 
+     * @param frame Pointer to store the decoded frame
+     * @return true if a frame was read, false when no more frames are stored
+     */
+    bool readNext(fdc1004_history_frame_t* frame);
+    
+    /**
+     * @brief Drop all stored frames
+     */
+    void clear();
+    
+    /**
+     * @brief Get the number of frames currently stored
+     * @return Frame count
+     */
+    uint32_t getFrameCount() const;
+    
+    /**
+     * @brief Get the number of arena bytes holding encoded frames
+     * @return Bytes in use, including block headers
+     */
+    size_t getUsedBytes() const;
+
+private:
+    uint8_t* _arena;                ///< Block storage
+    uint16_t _block_count;          ///< Number of blocks in the arena
+    uint8_t _channel_count;         ///< Channels stored per frame
+    
+    uint32_t _first_block;          ///< Sequence number of the oldest stored block
+    uint32_t _next_block;           ///< Sequence number of the block after the newest
+    uint32_t _frame_count;          ///< Frames stored in all blocks
+    fdc1004_history_frame_t _last;  ///< Last appended frame, base for the next delta
+    
+    uint32_t _read_block;           ///< Sequence number of the block under the read cursor
+    uint16_t _read_offset;          ///< Nibble offset of the next frame in that block
+    uint8_t _read_frame;            ///< Index of the next frame in that block
+    fdc1004_history_frame_t _read_last; ///< Last decoded frame, base for the next delta
+    
+    /**
+     * @brief Get the arena address of a block
+     * @param sequence Block sequence number
+     * @return Pointer to the block header
+     */
+    uint8_t* block(uint32_t sequence) const;
+    
+    /**
+     * @brief Encode a frame as a keyframe or as a delta against the last frame
+     * @param frame Frame to encode
+     * @param keyframe true to store absolute values
+     * @param out Buffer of FDC1004_HISTORY_MAX_FRAME_NIBBLES entries, one nibble each
+     * @return Encoded length in nibbles
+     */
+    uint8_t encodeFrame(const fdc1004_history_frame_t* frame, bool keyframe, uint8_t* out) const;
+    
+    /**
+     * @brief Decode one frame from a block
+     * @param data Block to read from
+     * @param position Nibble offset of the frame
+     * @param end Nibble offset just past the block's last frame
+     * @param keyframe true if the frame holds absolute values
+     * @param frame In: previous frame for deltas; out: decoded frame
+     * @return Nibbles consumed, 0 if the data is malformed
+     */
+    uint8_t decodeFrame(const uint8_t* data, uint16_t position, uint16_t end, bool keyframe, fdc1004_history_frame_t* frame) const;
+};
+
+#endif // _FDC1004_HISTORY